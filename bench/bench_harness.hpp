@@ -0,0 +1,263 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_BENCH_HARNESS_HPP_INCLUDED
+#define TCB_BENCH_HARNESS_HPP_INCLUDED
+
+#include "perf_counters.hpp"
+
+#include <tcb/rational.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+// Prevents the compiler from discarding a computed value
+template <typename T>
+inline void do_not_optimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+/*
+ * A minimal benchmark runner.
+ *
+ * Each benchmark is a callable taking an iteration count. The count is
+ * doubled until one run takes at least the minimum time, and the fastest
+ * of several such runs is reported.
+ *
+ * Command line options:
+ *   --filter=<text>    only run benchmarks whose name contains text
+ *   --min-time=<ms>    minimum duration of each timed run (default 20)
+ *   --repeat=<n>       number of timed runs to take the best of (default 3)
+ *   --perf             also read hardware performance counters (Linux only),
+ *                      reporting cycles, instructions, IPC, branch and cache
+ *                      misses per operation and a histogram of cycles per
+ *                      operation across batches of iterations
+ */
+class runner {
+public:
+    runner(int argc, char** argv)
+    {
+        for (int i = 1; i < argc; ++i) {
+            const char* arg = argv[i];
+            if (std::strncmp(arg, "--filter=", 9) == 0) {
+                filter_ = arg + 9;
+            } else if (std::strncmp(arg, "--min-time=", 11) == 0) {
+                min_time_ = std::chrono::milliseconds(std::atoi(arg + 11));
+            } else if (std::strncmp(arg, "--repeat=", 9) == 0) {
+                repeat_ = std::max(1, std::atoi(arg + 9));
+            } else if (std::strcmp(arg, "--perf") == 0) {
+                counters_.reset(new perf_counters);
+                if (!counters_->available()) {
+                    std::fprintf(stderr, "Performance counters unavailable (%s); "
+                                         "reporting times only\n",
+                                 counters_->error().c_str());
+                    counters_.reset();
+                }
+            } else {
+                std::fprintf(stderr, "Unknown option %s\n", arg);
+                std::exit(EXIT_FAILURE);
+            }
+        }
+    }
+
+    bool enabled(const std::string& name) const
+    {
+        return filter_.empty() || name.find(filter_) != std::string::npos;
+    }
+
+    // Runs func and reports the time per operation, where each iteration
+    // performs ops_per_iteration operations. Returns the nanoseconds per
+    // operation, or a negative value if the benchmark was filtered out.
+    template <typename Func>
+    double run(const std::string& name, Func func, double ops_per_iteration = 1.0)
+    {
+        if (!enabled(name)) {
+            return -1.0;
+        }
+        if (!header_printed_) {
+            std::printf("%-44s %12s %14s\n", "benchmark", "ns/op", "ops/sec");
+            header_printed_ = true;
+        }
+
+        std::size_t iterations = 1;
+        double best_ns = 0.0;
+        while (true) {
+            const double ns = time(func, iterations);
+            if (ns >= static_cast<double>(duration_ns(min_time_).count())) {
+                best_ns = ns;
+                break;
+            }
+            iterations *= 2;
+        }
+        for (int i = 1; i < repeat_; ++i) {
+            best_ns = std::min(best_ns, time(func, iterations));
+        }
+
+        const double ns_per_op = best_ns / (static_cast<double>(iterations) * ops_per_iteration);
+        std::printf("%-44s %12.2f %14.0f\n", name.c_str(), ns_per_op, 1e9 / ns_per_op);
+        if (counters_) {
+            report_counters(func, iterations, ops_per_iteration);
+        }
+        return ns_per_op;
+    }
+
+private:
+    using clock = std::chrono::steady_clock;
+    using duration_ns = std::chrono::duration<double, std::nano>;
+
+    template <typename Func>
+    static double time(Func& func, std::size_t iterations)
+    {
+        const auto start = clock::now();
+        func(iterations);
+        return duration_ns(clock::now() - start).count();
+    }
+
+    // Repeats the timed run in batches, reading the counters around each
+    // batch so that the spread of cycles per operation can be shown
+    template <typename Func>
+    void report_counters(Func& func, std::size_t iterations, double ops_per_iteration)
+    {
+        constexpr int num_batches = 32;
+        const std::size_t batch_size = std::max<std::size_t>(1, iterations / num_batches);
+        const double ops_per_batch = static_cast<double>(batch_size) * ops_per_iteration;
+
+        perf_counters::sample total;
+        std::vector<double> cycles_per_op;
+        for (int b = 0; b < num_batches; ++b) {
+            counters_->start();
+            func(batch_size);
+            const auto sample = counters_->stop();
+            for (int i = 0; i < perf_counters::num_counters; ++i) {
+                total.values[i] += sample.values[i];
+                total.valid[i] = sample.valid[i];
+            }
+            if (sample.valid[perf_counters::cycles]) {
+                cycles_per_op.push_back(sample.values[perf_counters::cycles] / ops_per_batch);
+            }
+        }
+
+        const double total_ops = ops_per_batch * num_batches;
+        const auto per_op = [&](perf_counters::counter c) {
+            return total.valid[c] ? static_cast<double>(total.values[c]) / total_ops : -1.0;
+        };
+        const double cycles = per_op(perf_counters::cycles);
+        const double instructions = per_op(perf_counters::instructions);
+        std::printf("    cycles/op %.1f  instructions/op ", cycles);
+        print_optional(instructions, "%.1f");
+        std::printf("  IPC ");
+        print_optional(instructions >= 0 && cycles > 0 ? instructions / cycles : -1.0, "%.2f");
+        std::printf("  branch-misses/op ");
+        print_optional(per_op(perf_counters::branch_misses), "%.3f");
+        std::printf("  cache-misses/op ");
+        print_optional(per_op(perf_counters::cache_misses), "%.4f");
+        std::printf("\n");
+
+        print_histogram(cycles_per_op);
+    }
+
+    static void print_optional(double value, const char* format)
+    {
+        if (value < 0) {
+            std::printf("n/a");
+        } else {
+            std::printf(format, value);
+        }
+    }
+
+    static void print_histogram(std::vector<double> values)
+    {
+        if (values.empty()) {
+            return;
+        }
+        std::sort(values.begin(), values.end());
+        const double lo = values.front();
+        const double hi = values.back();
+        std::printf("    cycles/op per batch: min %.1f  median %.1f  p90 %.1f  max %.1f\n",
+                    lo, values[values.size() / 2], values[values.size() * 9 / 10], hi);
+
+        constexpr int num_buckets = 8;
+        constexpr int bar_width = 40;
+        int counts[num_buckets] = {};
+        const double width = (hi - lo) / num_buckets;
+        for (const double v : values) {
+            const int bucket = width > 0 ? static_cast<int>((v - lo) / width) : 0;
+            ++counts[std::min(bucket, num_buckets - 1)];
+        }
+        const int max_count = *std::max_element(counts, counts + num_buckets);
+        for (int i = 0; i < num_buckets; ++i) {
+            if (width <= 0 && i > 0) {
+                break;
+            }
+            std::printf("    %10.1f | %-*s %d\n", lo + i * width, bar_width,
+                        std::string(static_cast<std::size_t>(counts[i] * bar_width / max_count), '#').c_str(),
+                        counts[i]);
+        }
+    }
+
+    std::string filter_;
+    std::chrono::milliseconds min_time_{20};
+    int repeat_ = 3;
+    bool header_printed_ = false;
+    std::unique_ptr<perf_counters> counters_;
+};
+
+/*
+ * Operand generation
+ */
+
+// A random integer whose magnitude has exactly bits significant bits (or is
+// zero, if bits is zero), negative with probability one half if T is signed
+template <typename T, typename Gen>
+T random_integer(Gen& gen, int bits)
+{
+    using unsigned_type = std::make_unsigned_t<T>;
+    if (bits <= 0) {
+        return 0;
+    }
+    const unsigned_type top = static_cast<unsigned_type>(unsigned_type{1} << (bits - 1));
+    std::uniform_int_distribution<unsigned long long> dist(
+            0, static_cast<unsigned long long>(top - 1));
+    const auto mag = static_cast<unsigned_type>(top | dist(gen));
+    const bool negative = std::is_signed<T>::value && (gen() & 1);
+    return static_cast<T>(negative ? static_cast<unsigned_type>(0u - mag) : mag);
+}
+
+// Random rationals whose numerators and (positive) denominators have the
+// given bit length before simplification
+template <typename T, typename Gen>
+std::vector<tcb::rational<T>> random_rationals(Gen& gen, std::size_t count, int bits)
+{
+    std::vector<tcb::rational<T>> result;
+    result.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const T num = random_integer<T>(gen, bits);
+        T denom = random_integer<T>(gen, bits);
+        if (denom < 0) {
+            denom = static_cast<T>(-denom);
+        }
+        result.emplace_back(num, denom);
+    }
+    return result;
+}
+
+} // end namespace bench
+
+#endif // TCB_BENCH_HARNESS_HPP_INCLUDED
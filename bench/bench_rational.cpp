@@ -0,0 +1,153 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Microbenchmarks for each operation in rational.hpp, at each width
+
+#include "bench_harness.hpp"
+
+#include <sstream>
+
+namespace {
+
+constexpr std::size_t num_operands = 1024;
+
+template <typename T>
+void bench_width(bench::runner& runner, const char* type_name, int bits)
+{
+    using rational = tcb::rational<T>;
+
+    std::mt19937_64 gen{static_cast<std::uint64_t>(bits) * 31 + sizeof(T)};
+    const auto lhs = bench::random_rationals<T>(gen, num_operands, bits);
+    const auto rhs = bench::random_rationals<T>(gen, num_operands, bits);
+    std::vector<T> nums(num_operands);
+    std::vector<T> denoms(num_operands);
+    for (std::size_t i = 0; i < num_operands; ++i) {
+        nums[i] = bench::random_integer<T>(gen, bits);
+        denoms[i] = static_cast<T>(bench::random_integer<std::make_unsigned_t<T>>(gen, bits));
+    }
+
+    // Operands which the operators treat specially: integers, and pairs
+    // sharing a denominator
+    std::vector<rational> integers(num_operands);
+    std::vector<rational> shared(num_operands);
+    for (std::size_t i = 0; i < num_operands; ++i) {
+        integers[i] = nums[i];
+        shared[i] = rational{nums[(i + 1) & (num_operands - 1)], lhs[i].denom()};
+    }
+
+    const std::string prefix = std::string{type_name} + "/" + std::to_string(bits) + "bit/";
+    const std::size_t mask = num_operands - 1;
+
+    // Applies op to each pair of operands in turn
+    const auto binary = [&](const char* name, auto op) {
+        runner.run(prefix + name, [&](std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                bench::do_not_optimize(op(lhs[i & mask], rhs[i & mask]));
+            }
+        });
+    };
+    const auto binary_on = [&](const std::string& name, const std::vector<rational>& a,
+                               const std::vector<rational>& b, auto op) {
+        runner.run(prefix + name, [&](std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                bench::do_not_optimize(op(a[i & mask], b[i & mask]));
+            }
+        });
+    };
+    const auto unary = [&](const char* name, auto op) {
+        runner.run(prefix + name, [&](std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                bench::do_not_optimize(op(lhs[i & mask]));
+            }
+        });
+    };
+
+    /* Construction */
+
+    runner.run(prefix + "construct(num, denom)", [&](std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            bench::do_not_optimize(rational{nums[i & mask], denoms[i & mask]});
+        }
+    });
+    runner.run(prefix + "construct(integer)", [&](std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            bench::do_not_optimize(rational{nums[i & mask]});
+        }
+    });
+
+    /* Arithmetic */
+
+    unary("negate", [](const rational& a) { return -a; });
+    // Cubes only fit for the narrower operands
+    if (3 * bits < std::numeric_limits<T>::digits) {
+        unary("pow3", [](const rational& a) { return tcb::pow(a, 3); });
+        unary("pow3_by_multiplication", [](const rational& a) { return a * a * a; });
+    }
+    binary("add", [](const rational& a, const rational& b) { return a + b; });
+    binary("subtract", [](const rational& a, const rational& b) { return a - b; });
+    binary("multiply", [](const rational& a, const rational& b) { return a * b; });
+    // Numerators are never zero, as their top bit is always set
+    binary("divide", [](const rational& a, const rational& b) { return a / b; });
+    binary("add_assign", [](rational a, const rational& b) { return a += b; });
+    binary("multiply_assign", [](rational a, const rational& b) { return a *= b; });
+    binary("add_integer", [](const rational& a, const rational& b) { return a + b.num(); });
+
+    const auto add = [](const rational& a, const rational& b) { return a + b; };
+    const auto multiply = [](const rational& a, const rational& b) { return a * b; };
+    binary_on("add/integers", integers, integers, add);
+    binary_on("add/rational+integer", lhs, integers, add);
+    binary_on("add/same_denominator", lhs, shared, add);
+    binary_on("multiply/integers", integers, integers, multiply);
+    binary_on("multiply/rational*integer", lhs, integers, multiply);
+
+    /* Comparison */
+
+    binary("equal", [](const rational& a, const rational& b) { return a == b; });
+    binary("less", [](const rational& a, const rational& b) { return a < b; });
+
+    /* Conversion */
+
+    unary("to_long_double", [](const rational& a) { return static_cast<long double>(a); });
+    unary("to_double", [](const rational& a) { return static_cast<double>(a); });
+    unary("to_rational_max_t", [](const rational& a) {
+        return static_cast<tcb::rational_max_t>(a);
+    });
+
+    /* I/O */
+
+    runner.run(prefix + "ostream", [&](std::size_t n) {
+        std::ostringstream os;
+        for (std::size_t i = 0; i < n; ++i) {
+            os << lhs[i & mask];
+            if ((i & mask) == mask) {
+                os.str({});
+            }
+        }
+        bench::do_not_optimize(os);
+    });
+}
+
+// Benchmarks T at a quarter and a half of its width. Operands of up to half
+// width keep the intermediate products of the binary operators in range.
+template <typename T>
+void bench_widths(bench::runner& runner, const char* type_name)
+{
+    const int digits = std::numeric_limits<T>::digits;
+    bench_width<T>(runner, type_name, std::max(1, digits / 4));
+    bench_width<T>(runner, type_name, digits / 2 - 1);
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    bench::runner runner{argc, argv};
+
+    bench_widths<std::int_least8_t>(runner, "rational8_t");
+    bench_widths<std::int_least16_t>(runner, "rational16_t");
+    bench_widths<std::int_least32_t>(runner, "rational32_t");
+    bench_widths<std::int_least64_t>(runner, "rational64_t");
+    bench_widths<std::intmax_t>(runner, "rational_max_t");
+}
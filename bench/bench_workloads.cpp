@@ -0,0 +1,418 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// End-to-end workloads, in which operands grow as the computation proceeds.
+// Each reports its throughput in rational operations per second, the
+// largest operand seen (in bits) and the number of GCDs computed per run.
+//
+// Problem sizes for the fixed-width types are chosen so that no
+// intermediate product overflows 64 bits.
+
+#include <cstdint>
+
+namespace bench {
+std::uint64_t gcd_calls = 0;
+}
+
+#define TCB_RATIONAL_GCD_HOOK(a, b) (++::bench::gcd_calls)
+
+#include "bench_harness.hpp"
+
+#include <tcb/big_rational.hpp>
+#include <tcb/dixon_solver.hpp>
+#include <tcb/rational_sequences.hpp>
+#include <tcb/rescale.hpp>
+
+namespace {
+
+/*
+ * Operand size tracking
+ */
+
+template <typename T>
+std::size_t bit_length(T value)
+{
+    using unsigned_type = std::make_unsigned_t<T>;
+    auto mag = static_cast<unsigned_type>(value);
+    if (value < 0) {
+        mag = static_cast<unsigned_type>(0u - mag);
+    }
+    std::size_t bits = 0;
+    for (; mag != 0; mag >>= 1) {
+        ++bits;
+    }
+    return bits;
+}
+
+template <typename T>
+std::size_t bit_length(const tcb::rational<T>& r)
+{
+    return std::max(bit_length(r.num()), bit_length(r.denom()));
+}
+
+std::size_t bit_length(const tcb::big_rational& r)
+{
+    return std::max(r.num().bit_width(), r.denom().bit_width());
+}
+
+// Passed each result as it is computed. The timed runs use null_tracker,
+// so that tracking does not distort the timings.
+struct tracker {
+    template <typename R>
+    const R& operator()(const R& r)
+    {
+        ++ops;
+        peak_bits = std::max(peak_bits, bit_length(r));
+        return r;
+    }
+
+    std::uint64_t ops = 0;
+    std::size_t peak_bits = 0;
+};
+
+struct null_tracker {
+    template <typename R>
+    const R& operator()(const R& r) { return r; }
+};
+
+/*
+ * Workloads
+ */
+
+// H_n = 1 + 1/2 + ... + 1/n
+template <typename R, typename Track>
+R harmonic(int n, Track& track)
+{
+    R sum{0};
+    for (int k = 1; k <= n; ++k) {
+        sum = track(sum + R{tcb::rational<int>{1, k}});
+    }
+    return sum;
+}
+
+// B_n (with B_1 = +1/2) by the Akiyama-Tanigawa algorithm
+template <typename R, typename Track>
+R bernoulli(int n, Track& track)
+{
+    std::vector<R> a(static_cast<std::size_t>(n) + 1);
+    for (int m = 0; m <= n; ++m) {
+        a[m] = R{tcb::rational<int>{1, m + 1}};
+        for (int j = m; j > 0; --j) {
+            a[j - 1] = track(R{j} * track(a[j - 1] - a[j]));
+        }
+    }
+    return a[0];
+}
+
+// The determinant of a matrix of small integers, by Gaussian elimination
+// over the rationals
+template <typename R, typename Track>
+R determinant(std::vector<std::vector<R>> m, Track& track)
+{
+    const std::size_t n = m.size();
+    R det{1};
+    for (std::size_t k = 0; k < n; ++k) {
+        std::size_t pivot = k;
+        while (pivot < n && m[pivot][k] == R{0}) {
+            ++pivot;
+        }
+        if (pivot == n) {
+            return R{0};
+        }
+        if (pivot != k) {
+            std::swap(m[pivot], m[k]);
+            det = -det;
+        }
+        det = track(det * m[k][k]);
+        for (std::size_t i = k + 1; i < n; ++i) {
+            const R factor = track(m[i][k] / m[k][k]);
+            for (std::size_t j = k; j < n; ++j) {
+                m[i][j] = track(m[i][j] - track(factor * m[k][j]));
+            }
+        }
+    }
+    return det;
+}
+
+template <typename R>
+std::vector<std::vector<R>> random_matrix(std::size_t n, std::uint64_t seed)
+{
+    std::mt19937_64 gen{seed};
+    std::uniform_int_distribution<int> dist(-9, 9);
+    std::vector<std::vector<R>> m(n, std::vector<R>(n));
+    for (auto& row : m) {
+        for (auto& elem : row) {
+            elem = R{dist(gen)};
+        }
+    }
+    return m;
+}
+
+// Solves a system of small integers by Gaussian elimination over the
+// rationals, where a is row-major
+template <typename Track>
+std::vector<tcb::big_rational> solve(const std::vector<int>& a, const std::vector<int>& b,
+                                     Track& track)
+{
+    using R = tcb::big_rational;
+    const std::size_t n = b.size();
+    std::vector<std::vector<R>> m(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            m[i].emplace_back(a[i * n + j]);
+        }
+        m[i].emplace_back(b[i]);
+    }
+    for (std::size_t k = 0; k < n; ++k) {
+        std::size_t pivot = k;
+        while (pivot < n && m[pivot][k] == R{0}) {
+            ++pivot;
+        }
+        if (pivot == n) {
+            std::abort();
+        }
+        std::swap(m[pivot], m[k]);
+        for (std::size_t i = k + 1; i < n; ++i) {
+            const R factor = track(m[i][k] / m[k][k]);
+            for (std::size_t j = k; j <= n; ++j) {
+                m[i][j] = track(m[i][j] - track(factor * m[k][j]));
+            }
+        }
+    }
+    std::vector<R> x(n);
+    for (std::size_t i = n; i-- > 0;) {
+        R sum = m[i][n];
+        for (std::size_t j = i + 1; j < n; ++j) {
+            sum = track(sum - track(m[i][j] * x[j]));
+        }
+        x[i] = track(sum / m[i][i]);
+    }
+    return x;
+}
+
+// As solve(), by p-adic lifting with tcb::dixon_solve. Only the results are
+// tracked.
+template <typename Track>
+std::vector<tcb::big_rational> solve_dixon(const std::vector<int>& a, const std::vector<int>& b,
+                                           Track& track)
+{
+    std::vector<tcb::big_rational> x;
+    if (!tcb::dixon_solve(a, b, x)) {
+        std::abort();
+    }
+    for (const auto& elem : x) {
+        track(elem);
+    }
+    return x;
+}
+
+// Walks the Farey sequence of order n, constructing each term as a rational
+// and checking that the terms are increasing. Returns the number of terms.
+template <typename T, typename Track>
+std::size_t farey(T n, Track& track)
+{
+    T a = 0, b = 1, c = 1, d = n;
+    tcb::rational<T> prev{a, b};
+    std::size_t count = 1;
+    while (c <= n) {
+        const T k = (n + b) / d;
+        const T next_c = k * c - a;
+        const T next_d = k * d - b;
+        a = c;
+        b = d;
+        c = next_c;
+        d = next_d;
+        const tcb::rational<T> term = track(tcb::rational<T>{a, b});
+        if (!(prev < term)) {
+            std::abort();
+        }
+        prev = term;
+        ++count;
+    }
+    return count;
+}
+
+// As farey(), but with terms from tcb::farey_sequence, which needs no GCDs
+template <typename T, typename Track>
+std::size_t farey_view(T n, Track& track)
+{
+    tcb::rational<T> prev{-1};
+    std::size_t count = 0;
+    for (const auto f : tcb::farey_sequence(n)) {
+        const tcb::rational<T> term = track(f);
+        if (!(prev < term)) {
+            std::abort();
+        }
+        prev = term;
+        ++count;
+    }
+    return count;
+}
+
+// Finds the best approximation to target with denominator at most
+// max_denom by descending the Stern-Brocot tree
+template <typename T, typename Track>
+tcb::rational<T> stern_brocot(const tcb::rational<T>& target, T max_denom, Track& track)
+{
+    T lo_num = 0, lo_denom = 1;
+    T hi_num = 1, hi_denom = 0;
+    while (true) {
+        const T num = lo_num + hi_num;
+        const T denom = lo_denom + hi_denom;
+        if (denom > max_denom) {
+            break;
+        }
+        const tcb::rational<T> mediant = track(tcb::rational<T>{num, denom});
+        if (mediant == target) {
+            return mediant;
+        }
+        if (mediant < target) {
+            lo_num = num;
+            lo_denom = denom;
+        } else {
+            hi_num = num;
+            hi_denom = denom;
+        }
+    }
+    if (hi_denom == 0) {
+        return {lo_num, lo_denom};
+    }
+    const tcb::rational<T> lo{lo_num, lo_denom};
+    const tcb::rational<T> hi{hi_num, hi_denom};
+    return track(target - lo) < track(hi - target) ? lo : hi;
+}
+
+// Converts timestamps between timebases with rational arithmetic
+template <typename Track>
+std::int64_t rescale_naive(const std::vector<std::int64_t>& timestamps,
+                           const tcb::rational64_t& from, const tcb::rational64_t& to,
+                           Track& track)
+{
+    std::int64_t checksum = 0;
+    for (const auto ts : timestamps) {
+        const auto r = track(track(tcb::rational64_t{ts} * from) / to);
+        checksum += r.num() / r.denom();
+    }
+    return checksum;
+}
+
+/*
+ * Reporting
+ */
+
+// Runs the workload once to gather statistics, then times it
+template <typename Workload>
+void run_workload(bench::runner& runner, const std::string& name, Workload workload)
+{
+    if (!runner.enabled(name)) {
+        return;
+    }
+    tracker stats;
+    bench::gcd_calls = 0;
+    workload(stats);
+    const std::uint64_t gcds = bench::gcd_calls;
+
+    null_tracker null;
+    runner.run(name, [&](std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            workload(null);
+        }
+    }, static_cast<double>(std::max<std::uint64_t>(stats.ops, 1)));
+    std::printf("    %llu ops/run, peak operand %zu bits, %llu GCDs/run\n",
+                static_cast<unsigned long long>(stats.ops), stats.peak_bits,
+                static_cast<unsigned long long>(gcds));
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    bench::runner runner{argc, argv};
+    using tcb::big_rational;
+    using tcb::rational64_t;
+
+    run_workload(runner, "harmonic/rational64_t/n=40", [](auto& track) {
+        bench::do_not_optimize(harmonic<rational64_t>(40, track));
+    });
+    run_workload(runner, "harmonic/big_rational/n=300", [](auto& track) {
+        bench::do_not_optimize(harmonic<big_rational>(300, track));
+    });
+
+    run_workload(runner, "bernoulli/rational64_t/n=20", [](auto& track) {
+        bench::do_not_optimize(bernoulli<rational64_t>(20, track));
+    });
+    run_workload(runner, "bernoulli/big_rational/n=60", [](auto& track) {
+        bench::do_not_optimize(bernoulli<big_rational>(60, track));
+    });
+
+    const auto small_matrix = random_matrix<rational64_t>(6, 1);
+    run_workload(runner, "determinant/rational64_t/6x6", [&](auto& track) {
+        bench::do_not_optimize(determinant(small_matrix, track));
+    });
+    const auto big_matrix = random_matrix<big_rational>(16, 1);
+    run_workload(runner, "determinant/big_rational/16x16", [&](auto& track) {
+        bench::do_not_optimize(determinant(big_matrix, track));
+    });
+
+    std::vector<int> system(24 * 25);
+    {
+        std::mt19937_64 gen{4};
+        std::uniform_int_distribution<int> dist(-9, 9);
+        for (auto& elem : system) {
+            elem = dist(gen);
+        }
+    }
+    const std::vector<int> coeffs(system.begin(), system.begin() + 24 * 24);
+    const std::vector<int> rhs(system.begin() + 24 * 24, system.end());
+    run_workload(runner, "solve/big_rational/24x24", [&](auto& track) {
+        bench::do_not_optimize(solve(coeffs, rhs, track));
+    });
+    run_workload(runner, "solve/dixon_solve/24x24", [&](auto& track) {
+        bench::do_not_optimize(solve_dixon(coeffs, rhs, track));
+    });
+
+    run_workload(runner, "farey/rational32_t/n=300", [](auto& track) {
+        bench::do_not_optimize(farey<std::int32_t>(300, track));
+    });
+    run_workload(runner, "farey/farey_sequence/n=300", [](auto& track) {
+        bench::do_not_optimize(farey_view<std::int32_t>(300, track));
+    });
+
+    std::vector<rational64_t> targets;
+    {
+        std::mt19937_64 gen{2};
+        std::uniform_int_distribution<std::int64_t> dist(1, std::int64_t{8} << 30);
+        for (int i = 0; i < 256; ++i) {
+            targets.emplace_back(dist(gen), std::int64_t{1} << 30);
+        }
+    }
+    run_workload(runner, "stern_brocot/rational64_t/max_denom=2^20", [&](auto& track) {
+        for (const auto& target : targets) {
+            bench::do_not_optimize(stern_brocot<std::int64_t>(target, 1 << 20, track));
+        }
+    });
+
+    std::vector<std::int64_t> timestamps(4096);
+    {
+        std::mt19937_64 gen{3};
+        std::uniform_int_distribution<std::int64_t> dist(0, std::int64_t{1} << 32);
+        for (auto& ts : timestamps) {
+            ts = dist(gen);
+        }
+    }
+    const rational64_t ntsc{1001, 30000};
+    const rational64_t mpeg{1, 90000};
+    run_workload(runner, "rescale/rational64_t/naive", [&](auto& track) {
+        bench::do_not_optimize(rescale_naive(timestamps, ntsc, mpeg, track));
+    });
+    std::vector<std::int64_t> rescaled(timestamps.size());
+    run_workload(runner, "rescale/rational64_t/tcb::rescale", [&](auto& track) {
+        tcb::rescale(timestamps.begin(), timestamps.end(), rescaled.begin(), ntsc, mpeg);
+        for (const auto ts : rescaled) {
+            track(ts);
+        }
+        bench::do_not_optimize(rescaled);
+    });
+}
@@ -0,0 +1,130 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_BENCH_PERF_COUNTERS_HPP_INCLUDED
+#define TCB_BENCH_PERF_COUNTERS_HPP_INCLUDED
+
+#include <cstdint>
+#include <string>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/perf_event.h>)
+#define TCB_BENCH_HAVE_PERF_EVENT
+#endif
+#endif
+
+#ifdef TCB_BENCH_HAVE_PERF_EVENT
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bench {
+
+/*
+ * Hardware performance counters for the calling thread, read with Linux's
+ * perf_event_open(2).
+ *
+ * Counters are often unavailable, for example in containers or when
+ * perf_event_paranoid forbids them. In that case available() returns false,
+ * error() says why, and start() and stop() do nothing. Counters which the
+ * CPU does not support are reported as unavailable individually.
+ */
+class perf_counters {
+public:
+    enum counter { cycles, instructions, branch_misses, cache_misses, num_counters };
+
+    struct sample {
+        std::uint64_t values[num_counters] = {};
+        bool valid[num_counters] = {};
+    };
+
+    perf_counters()
+    {
+#ifdef TCB_BENCH_HAVE_PERF_EVENT
+        static const std::uint64_t configs[num_counters] = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_HW_CACHE_MISSES
+        };
+        for (int i = 0; i < num_counters; ++i) {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[i];
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            fds_[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+            if (fds_[i] < 0 && i == cycles) {
+                error_ = std::strerror(errno);
+                return;
+            }
+        }
+#else
+        error_ = "not supported on this platform";
+#endif
+    }
+
+    ~perf_counters()
+    {
+#ifdef TCB_BENCH_HAVE_PERF_EVENT
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    perf_counters(const perf_counters&) = delete;
+    perf_counters& operator=(const perf_counters&) = delete;
+
+    bool available() const { return fds_[cycles] >= 0; }
+
+    const std::string& error() const { return error_; }
+
+    void start()
+    {
+#ifdef TCB_BENCH_HAVE_PERF_EVENT
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    sample stop()
+    {
+        sample result;
+#ifdef TCB_BENCH_HAVE_PERF_EVENT
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+        for (int i = 0; i < num_counters; ++i) {
+            std::uint64_t value = 0;
+            if (fds_[i] >= 0 && read(fds_[i], &value, sizeof(value)) == sizeof(value)) {
+                result.values[i] = value;
+                result.valid[i] = true;
+            }
+        }
+#endif
+        return result;
+    }
+
+private:
+    int fds_[num_counters] = {-1, -1, -1, -1};
+    std::string error_;
+};
+
+} // end namespace bench
+
+#endif // TCB_BENCH_PERF_COUNTERS_HPP_INCLUDED
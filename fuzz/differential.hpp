@@ -0,0 +1,470 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_FUZZ_DIFFERENTIAL_HPP_INCLUDED
+#define TCB_FUZZ_DIFFERENTIAL_HPP_INCLUDED
+
+/*
+ * Differential checks of rational<T> against an exact reference.
+ *
+ * Each check computes the exact result of an operation as an unreduced
+ * fraction of reference integers, which are wide enough that nothing
+ * overflows: std::int64_t for operands of up to 32 bits, and __int128 (or
+ * tcb::big_integer, where __int128 is unavailable) for 64-bit operands.
+ * The reference is reduced with its own GCD, independent of the library's.
+ *
+ * rational<T> itself is only exact within its preconditions, so each
+ * operation is performed only if the intermediate values of the textbook
+ * formula (n1*d2 + n2*d1 over d1*d2, and so on) fit in the type the
+ * operator computes in, and the reduced result fits in the result type.
+ * Values are required to be greater than the type's minimum, which cannot
+ * be negated. Any fast path must give the exact result for all such inputs;
+ * cases outside the contract are counted as skipped.
+ *
+ * The operators are checked under the result policy in effect, so building
+ * with TCB_RATIONAL_RESULT_POLICY set checks that policy instead.
+ */
+
+#include <tcb/rational.hpp>
+
+#ifndef TCB_RATIONAL_HAVE_INT128
+#include <tcb/big_integer.hpp>
+#endif
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <initializer_list>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+namespace fuzz {
+
+template <typename T>
+using reference_int_t = std::conditional_t<(sizeof(T) <= 4), std::int64_t,
+#ifdef TCB_RATIONAL_HAVE_INT128
+                                           tcb::detail::int128_t
+#else
+                                           tcb::big_integer
+#endif
+                                           >;
+
+// An exact value, with denom > 0 and gcd(num, denom) == 1
+template <typename W>
+struct exact {
+    W num;
+    W denom;
+};
+
+template <typename W>
+exact<W> reduce(W num, W denom)
+{
+    W a = num < 0 ? W(-num) : num;
+    W b = denom < 0 ? W(-denom) : denom;
+    while (b != 0) {
+        W t = a % b;
+        a = b;
+        b = t;
+    }
+    if (denom < 0) {
+        num = -num;
+        denom = -denom;
+    }
+    return {num / a, denom / a};
+}
+
+// Whether value is representable in C, excluding its minimum
+template <typename C, typename W>
+bool fits(const W& value)
+{
+    const W max = W(std::numeric_limits<C>::max());
+    return value <= max && -max <= value;
+}
+
+template <typename C, typename W>
+bool fits(const exact<W>& value)
+{
+    return fits<C>(value.num) && fits<C>(value.denom);
+}
+
+template <typename W>
+std::string decimal(W value)
+{
+    if (value == 0) {
+        return "0";
+    }
+    const bool negative = value < 0;
+    std::string digits;
+    for (; value != 0; value = value / 10) {
+        const int digit = static_cast<int>(value % 10);
+        digits.insert(digits.begin(), static_cast<char>('0' + (digit < 0 ? -digit : digit)));
+    }
+    return negative ? "-" + digits : digits;
+}
+
+template <typename W>
+std::string describe(const W& num, const W& denom)
+{
+    return denom == 1 ? decimal(num) : decimal(num) + "/" + decimal(denom);
+}
+
+template <typename T>
+std::string describe(const tcb::rational<T>& r)
+{
+    return describe<long long>(r.num(), r.denom());
+}
+
+struct statistics {
+    std::uint64_t checks = 0;
+    std::uint64_t skipped = 0;
+    std::uint64_t failures = 0;
+};
+
+/*
+ * Runs the checks for one value type, recording the outcome in stats.
+ * Failures are reported to stderr (up to max_reports of them) and, if
+ * abort_on_failure is set, abort the program so that a fuzzer records the
+ * input. Operands are only formatted when a check fails.
+ */
+template <typename T>
+class checker {
+public:
+    using value_type = T;
+    using rational = tcb::rational<T>;
+    using reference_type = reference_int_t<T>;
+    using exact_type = exact<reference_type>;
+
+    checker(const char* type_name, statistics& stats)
+        : type_name_(type_name), stats_(stats)
+    {}
+
+    std::uint64_t max_reports = 10;
+    bool abort_on_failure = false;
+
+    // Checks construction from num and denom. If it is within the
+    // contract, stores the result in out and returns true.
+    bool construct(T num, T denom, rational& out)
+    {
+        if (denom == 0 || !fits<T>(W(num)) || !fits<T>(W(denom))) {
+            ++stats_.skipped;
+            return false;
+        }
+        out = rational{num, denom};
+        expect_equal("construct", {W(num), W(denom)}, out, reduce(W(num), W(denom)));
+        return true;
+    }
+
+    // Checks every operation on a single (reduced) value
+    void unary(const rational& a)
+    {
+        const exact_type ea = value_of(a);
+
+        expect_equal("-", ea, -a, exact_type{-ea.num, ea.denom});
+
+        const long double expected = static_cast<long double>(ea.num) /
+                                     static_cast<long double>(ea.denom);
+        ++stats_.checks;
+        if (static_cast<long double>(a) != expected) {
+            fail("long double", "", describe(ea.num, ea.denom),
+                 std::to_string(expected), std::to_string(static_cast<long double>(a)));
+        }
+
+        power(a, ea, 2, "^ 2");
+        power(a, ea, 3, "^ 3");
+        power(a, ea, 5, "^ 5");
+        power(a, ea, -1, "^ -1");
+        power(a, ea, -2, "^ -2");
+
+        convert<tcb::detail::next_wider_t<T>>("widen", a, ea);
+        convert<narrower_t>("narrow", a, ea);
+
+        // Compile-time constants, which have their own fast paths
+        with_constant<tcb::static_rational<1, 3>>(a, ea);
+        with_constant<tcb::static_rational<-5, 2>>(a, ea);
+        with_constant<tcb::static_rational<7>>(a, ea);
+        with_constant<tcb::static_rational<-1>>(a, ea);
+        with_constant<std::ratio<6, 4>>(a, ea);
+    }
+
+    // Checks every binary operation on two (reduced) values
+    void binary(const rational& a, const rational& b)
+    {
+        using compute_type = tcb::detail::rational_compute_t<rational, rational>;
+        using result_value_type = typename tcb::rational_result_t<rational, rational>::value_type;
+
+        const exact_type ea = value_of(a);
+        const exact_type eb = value_of(b);
+        const W n1d2 = ea.num * eb.denom;
+        const W n2d1 = eb.num * ea.denom;
+        const W d1d2 = ea.denom * eb.denom;
+        const W n1n2 = ea.num * eb.num;
+        const W sum = n1d2 + n2d1;
+        const W difference = n1d2 - n2d1;
+
+        /* Binary operators */
+
+        check<result_value_type>("+", ea, eb, all_fit<compute_type>({n1d2, n2d1, sum, d1d2}),
+                                 sum, d1d2, [&] { return a + b; });
+        check<result_value_type>("-", ea, eb, all_fit<compute_type>({n1d2, n2d1, difference, d1d2}),
+                                 difference, d1d2, [&] { return a - b; });
+        check<result_value_type>("*", ea, eb, all_fit<compute_type>({n1n2, d1d2}),
+                                 n1n2, d1d2, [&] { return a * b; });
+        if (eb.num != 0) {
+            check<result_value_type>("/", ea, eb, all_fit<compute_type>({n1d2, n2d1}),
+                                     n1d2, n2d1, [&] { return a / b; });
+        }
+
+        /* Compound assignment, which computes in T */
+
+        check<T>("+=", ea, eb, all_fit<T>({n1d2, n2d1, sum, d1d2}),
+                 sum, d1d2, [&] { rational c = a; return c += b; });
+        check<T>("-=", ea, eb, all_fit<T>({n1d2, n2d1, difference, d1d2}),
+                 difference, d1d2, [&] { rational c = a; return c -= b; });
+        check<T>("*=", ea, eb, all_fit<T>({n1n2, d1d2}),
+                 n1n2, d1d2, [&] { rational c = a; return c *= b; });
+        if (eb.num != 0) {
+            check<T>("/=", ea, eb, all_fit<T>({n1d2, n2d1}),
+                     n1d2, n2d1, [&] { rational c = a; return c /= b; });
+        }
+
+        /* Mixed with an integer */
+
+        with_integer(a, ea, b.num());
+
+        /* Comparison */
+
+        const bool equal = ea.num == eb.num && ea.denom == eb.denom;
+        expect_bool("==", ea, eb, a == b, equal);
+        expect_bool("!=", ea, eb, a != b, !equal);
+
+        using product_type = decltype(T{} * T{});
+        if (all_fit<product_type>({n1d2, n2d1})) {
+            expect_bool("<", ea, eb, a < b, n1d2 < n2d1);
+            expect_bool(">", ea, eb, a > b, n1d2 > n2d1);
+            expect_bool("<=", ea, eb, a <= b, n1d2 <= n2d1);
+            expect_bool(">=", ea, eb, a >= b, n1d2 >= n2d1);
+        } else {
+            ++stats_.skipped;
+        }
+    }
+
+private:
+    using W = reference_type;
+
+    static constexpr int reference_digits = sizeof(T) <= 4 ? 63 : 127;
+
+    static int bit_length(W value)
+    {
+        int bits = 0;
+        for (value = value < 0 ? W(-value) : value; value != 0; value = value / 2) {
+            ++bits;
+        }
+        return bits;
+    }
+
+    using narrower_t = typename tcb::detail::sized_integer<
+            (sizeof(T) > 1 ? sizeof(T) / 2 : 1), true>::type;
+
+    static exact_type value_of(const rational& r)
+    {
+        return {W(r.num()), W(r.denom())};
+    }
+
+    template <typename C>
+    static bool all_fit(std::initializer_list<W> values)
+    {
+        for (const W& value : values) {
+            if (!fits<C>(value)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Performs op_func if its intermediates fit and the exact result, num
+    // over denom, fits in V, and checks its result
+    template <typename V, typename Op>
+    void check(const char* op, const exact_type& lhs, const exact_type& rhs, bool in_contract,
+               const W& num, const W& denom, Op op_func)
+    {
+        if (!in_contract) {
+            ++stats_.skipped;
+            return;
+        }
+        const exact_type expected = reduce(num, denom);
+        if (!fits<V>(expected)) {
+            ++stats_.skipped;
+            return;
+        }
+        expect_equal(op, lhs, rhs, op_func(), expected);
+    }
+
+    void with_integer(const rational& a, const exact_type& ea, T n)
+    {
+        using compute_type = tcb::detail::rational_compute_t<rational, T>;
+        using result_value_type = typename tcb::rational_result_t<rational, T>::value_type;
+        const exact_type en{W(n), W(1)};
+        const W product = ea.denom * en.num;
+
+        check<result_value_type>("+", ea, en, all_fit<compute_type>({product, ea.num + product}),
+                                 ea.num + product, ea.denom, [&] { return a + n; });
+        if (n != 0) {
+            check<result_value_type>("/", ea, en, all_fit<compute_type>({product}),
+                                     ea.num, product, [&] { return a / n; });
+        }
+    }
+
+    // Checks pow() and checked_pow(), which must succeed exactly when the
+    // result is representable
+    void power(const rational& a, const exact_type& ea, int n, const char* op)
+    {
+        if (ea.num == 0 && n < 0) {
+            return;
+        }
+        const int exp = n < 0 ? -n : n;
+        const exact_type base = n < 0 ? exact_type{ea.num < 0 ? W(-ea.denom) : ea.denom,
+                                                   ea.num < 0 ? W(-ea.num) : ea.num}
+                                      : ea;
+
+        rational checked{};
+        const bool checked_ok = tcb::checked_pow(a, n, checked);
+        ++stats_.checks;
+
+        // Terms this long could overflow the reference. Their powers are
+        // far too large for T.
+        const int max_bits = (reference_digits - 1) / exp;
+        if (bit_length(base.num) > max_bits || bit_length(base.denom) > max_bits) {
+            if (checked_ok) {
+                fail(op, "", describe(ea.num, ea.denom), "false (checked_pow)", "true");
+            }
+            return;
+        }
+
+        exact_type expected{1, 1};
+        for (int i = 0; i < exp; ++i) {
+            expected.num = expected.num * base.num;
+            expected.denom = expected.denom * base.denom;
+        }
+        const W max = W(std::numeric_limits<T>::max());
+        const bool representable = W(std::numeric_limits<T>::min()) <= expected.num &&
+                                   expected.num <= max && expected.denom <= max;
+        if (checked_ok != representable) {
+            fail(op, "", describe(ea.num, ea.denom),
+                 representable ? "true (checked_pow)" : "false (checked_pow)",
+                 checked_ok ? "true" : "false");
+        } else if (checked_ok) {
+            expect_equal(op, ea, checked, expected);
+        }
+
+        if (fits<T>(expected)) {
+            expect_equal(op, ea, tcb::pow(a, n), expected);
+        } else {
+            ++stats_.skipped;
+        }
+    }
+
+    template <typename U>
+    void convert(const char* op, const rational& a, const exact_type& ea)
+    {
+        if (!fits<U>(ea)) {
+            ++stats_.skipped;
+            return;
+        }
+        expect_equal(op, ea, static_cast<tcb::rational<U>>(a), ea);
+    }
+
+    template <typename S>
+    void with_constant(const rational& a, const exact_type& ea)
+    {
+        using compute_type = tcb::detail::rational_compute_t<rational, S>;
+        using result_value_type = typename tcb::rational_result_t<rational, S>::value_type;
+        const exact_type es{W(tcb::detail::static_ratio_t<S>::num),
+                            W(tcb::detail::static_ratio_t<S>::den)};
+        const S s{};
+
+        const W n1d2 = ea.num * es.denom;
+        const W n2d1 = es.num * ea.denom;
+        const W d1d2 = ea.denom * es.denom;
+        const W n1n2 = ea.num * es.num;
+        const W sum = n1d2 + n2d1;
+        const W difference = n1d2 - n2d1;
+
+        const bool sum_fits = all_fit<compute_type>({n1d2, n2d1, sum, d1d2});
+        check<result_value_type>("+", ea, es, sum_fits, sum, d1d2, [&] { return a + s; });
+        check<result_value_type>("+", es, ea, sum_fits, sum, d1d2, [&] { return s + a; });
+
+        const bool difference_fits = all_fit<compute_type>({n1d2, n2d1, difference, d1d2});
+        check<result_value_type>("-", ea, es, difference_fits, difference, d1d2,
+                                 [&] { return a - s; });
+        check<result_value_type>("-", es, ea, difference_fits, -difference, d1d2,
+                                 [&] { return s - a; });
+
+        const bool product_fits = all_fit<compute_type>({n1n2, d1d2});
+        check<result_value_type>("*", ea, es, product_fits, n1n2, d1d2, [&] { return a * s; });
+        check<result_value_type>("*", es, ea, product_fits, n1n2, d1d2, [&] { return s * a; });
+
+        const bool quotient_fits = all_fit<compute_type>({n1d2, n2d1});
+        if (es.num != 0) {
+            check<result_value_type>("/", ea, es, quotient_fits, n1d2, n2d1, [&] { return a / s; });
+        }
+        if (ea.num != 0) {
+            check<result_value_type>("/", es, ea, quotient_fits, n2d1, n1d2, [&] { return s / a; });
+        }
+    }
+
+    template <typename U>
+    void expect_equal(const char* op, const exact_type& operand,
+                      const tcb::rational<U>& result, const exact_type& expected)
+    {
+        ++stats_.checks;
+        if (W(result.num()) != expected.num || W(result.denom()) != expected.denom) {
+            fail(op, "", describe(operand.num, operand.denom),
+                 describe(expected.num, expected.denom), describe(result));
+        }
+    }
+
+    template <typename U>
+    void expect_equal(const char* op, const exact_type& lhs, const exact_type& rhs,
+                      const tcb::rational<U>& result, const exact_type& expected)
+    {
+        ++stats_.checks;
+        if (W(result.num()) != expected.num || W(result.denom()) != expected.denom) {
+            fail(describe(lhs.num, lhs.denom), op, describe(rhs.num, rhs.denom),
+                 describe(expected.num, expected.denom), describe(result));
+        }
+    }
+
+    void expect_bool(const char* op, const exact_type& lhs, const exact_type& rhs,
+                     bool result, bool expected)
+    {
+        ++stats_.checks;
+        if (result != expected) {
+            fail(describe(lhs.num, lhs.denom), op, describe(rhs.num, rhs.denom),
+                 expected ? "true" : "false", result ? "true" : "false");
+        }
+    }
+
+    // Reports "lhs op rhs", or "lhs rhs" for unary operations
+    void fail(const std::string& lhs, const char* op, const std::string& rhs,
+              const std::string& expected, const std::string& actual)
+    {
+        if (stats_.failures++ < max_reports) {
+            std::fprintf(stderr, "%s: %s %s%s%s: expected %s, got %s\n", type_name_,
+                         lhs.c_str(), op, *op ? " " : "", rhs.c_str(),
+                         expected.c_str(), actual.c_str());
+        }
+        if (abort_on_failure) {
+            std::abort();
+        }
+    }
+
+    const char* type_name_;
+    statistics& stats_;
+};
+
+} // end namespace fuzz
+
+#endif // TCB_FUZZ_DIFFERENTIAL_HPP_INCLUDED
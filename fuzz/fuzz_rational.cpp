@@ -0,0 +1,225 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Randomised differential testing of rational<T> against an exact
+// reference (see differential.hpp), for each of the sized rational types.
+//
+// Usage: fuzz_rational [options]
+//
+//   --cases=<n>         random operand pairs per type (default 100000)
+//   --seed=<n>          random seed (default 1)
+//   --exhaustive        also check every pair of rational8_t values, about
+//                       4 * 10^8 pairs
+//   --shard=<i>/<n>     check only the i-th of n slices of the exhaustive
+//                       pairs, so that they can be split across processes
+//   --max-failures=<n>  failures to report per type (default 10)
+//
+// Exits with a non-zero status if any check fails.
+
+#include "differential.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+struct options {
+    std::uint64_t cases = 100000;
+    std::uint64_t seed = 1;
+    bool exhaustive = false;
+    std::uint64_t shard = 0;
+    std::uint64_t num_shards = 1;
+    std::uint64_t max_failures = 10;
+};
+
+// SplitMix64: fast enough not to dominate the checks
+class generator {
+public:
+    explicit generator(std::uint64_t seed) : state_(seed) {}
+
+    std::uint64_t operator()()
+    {
+        std::uint64_t z = (state_ += 0x9e3779b97f4a7c15);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+        return z ^ (z >> 31);
+    }
+
+private:
+    std::uint64_t state_;
+};
+
+// A value whose bit length is uniformly distributed, so that small
+// operands, and pairs whose products just fit, are well represented.
+// One in sixteen is an edge case instead.
+template <typename T>
+T random_value(generator& gen)
+{
+    using unsigned_type = std::make_unsigned_t<T>;
+    constexpr int digits = std::numeric_limits<T>::digits;
+    const std::uint64_t r = gen();
+    const bool negative = (r & 1) != 0;
+    unsigned_type mag;
+    if ((r & 0x1e) == 0) {
+        const unsigned_type edges[] = {0, 1, 2, static_cast<unsigned_type>(std::numeric_limits<T>::max())};
+        mag = edges[(r >> 5) & 3];
+    } else {
+        const int bits = 1 + static_cast<int>((r >> 5) % digits);
+        const unsigned_type top = static_cast<unsigned_type>(unsigned_type{1} << (bits - 1));
+        mag = static_cast<unsigned_type>(top | (gen() & (top - 1)));
+    }
+    return static_cast<T>(negative ? static_cast<unsigned_type>(0u - mag) : mag);
+}
+
+// Turns some pairs into the shapes which the operators treat specially:
+// integers, and operands with the same denominator
+template <typename T>
+void make_special(generator& gen, tcb::rational<T>& a, tcb::rational<T>& b)
+{
+    using W = fuzz::reference_int_t<T>;
+    switch (gen() % 8) {
+    case 0:
+        a = a.num();
+        break;
+    case 1:
+        b = b.num();
+        break;
+    case 2:
+    case 3:
+        if (fuzz::reduce(W(b.num()), W(a.denom())).denom == W(a.denom())) {
+            b = tcb::rational<T>{tcb::normalized, b.num(), a.denom()};
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void report(const char* type_name, const fuzz::statistics& stats, double seconds)
+{
+    std::printf("%-14s %14llu checks %14llu skipped %8llu failures %12.0f checks/sec\n",
+                type_name, static_cast<unsigned long long>(stats.checks),
+                static_cast<unsigned long long>(stats.skipped),
+                static_cast<unsigned long long>(stats.failures),
+                seconds > 0 ? static_cast<double>(stats.checks) / seconds : 0.0);
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <typename T>
+bool run_random(const char* type_name, const options& opts)
+{
+    fuzz::statistics stats;
+    fuzz::checker<T> check{type_name, stats};
+    check.max_reports = opts.max_failures;
+    generator gen{opts.seed * 0x100 + sizeof(T)};
+
+    const auto start = std::chrono::steady_clock::now();
+    tcb::rational<T> a, b;
+    for (std::uint64_t i = 0; i < opts.cases; ++i) {
+        const bool have_a = check.construct(random_value<T>(gen), random_value<T>(gen), a);
+        const bool have_b = check.construct(random_value<T>(gen), random_value<T>(gen), b);
+        if (have_a && have_b) {
+            make_special(gen, a, b);
+        }
+        if (have_a) {
+            check.unary(a);
+        }
+        if (have_a && have_b) {
+            check.binary(a, b);
+        }
+    }
+    report(type_name, stats, seconds_since(start));
+    return stats.failures == 0;
+}
+
+// Every construction with operands greater than the minimum, then every
+// pair of the distinct values
+bool run_exhaustive(const options& opts)
+{
+    using T = std::int_least8_t;
+    const char* type_name = "rational8_t*";
+    fuzz::statistics stats;
+    fuzz::checker<T> check{type_name, stats};
+    check.max_reports = opts.max_failures;
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<tcb::rational<T>> values;
+    for (int num = -128; num <= 127; ++num) {
+        for (int denom = -128; denom <= 127; ++denom) {
+            tcb::rational<T> r;
+            if (check.construct(static_cast<T>(num), static_cast<T>(denom), r) &&
+                    r.num() == num && r.denom() == denom) {
+                values.push_back(r);
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        if (i % opts.num_shards != opts.shard) {
+            continue;
+        }
+        check.unary(values[i]);
+        for (const auto& b : values) {
+            check.binary(values[i], b);
+        }
+    }
+    report(type_name, stats, seconds_since(start));
+    return stats.failures == 0;
+}
+
+bool parse_uint(const char* text, std::uint64_t& out)
+{
+    char* end = nullptr;
+    out = std::strtoull(text, &end, 10);
+    return end != text && *end == '\0';
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    options opts;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool ok = true;
+        if (std::strncmp(arg, "--cases=", 8) == 0) {
+            ok = parse_uint(arg + 8, opts.cases);
+        } else if (std::strncmp(arg, "--seed=", 7) == 0) {
+            ok = parse_uint(arg + 7, opts.seed);
+        } else if (std::strcmp(arg, "--exhaustive") == 0) {
+            opts.exhaustive = true;
+        } else if (std::strncmp(arg, "--shard=", 8) == 0) {
+            const char* slash = std::strchr(arg + 8, '/');
+            ok = slash != nullptr &&
+                 parse_uint(std::string(arg + 8, slash).c_str(), opts.shard) &&
+                 parse_uint(slash + 1, opts.num_shards) &&
+                 opts.shard < opts.num_shards;
+            opts.exhaustive = true;
+        } else if (std::strncmp(arg, "--max-failures=", 15) == 0) {
+            ok = parse_uint(arg + 15, opts.max_failures);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            std::fprintf(stderr, "Invalid option %s\n", arg);
+            return EXIT_FAILURE;
+        }
+    }
+
+    bool passed = true;
+    if (opts.exhaustive) {
+        passed &= run_exhaustive(opts);
+    }
+    passed &= run_random<std::int_least8_t>("rational8_t", opts);
+    passed &= run_random<std::int_least16_t>("rational16_t", opts);
+    passed &= run_random<std::int_least32_t>("rational32_t", opts);
+    passed &= run_random<std::int_least64_t>("rational64_t", opts);
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,56 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// libFuzzer entry point for the differential checks in differential.hpp.
+//
+// The first byte of the input selects the value type, and the following
+// bytes give the numerators and denominators of two operands. A failed
+// check aborts, so that libFuzzer saves the input.
+
+#include "differential.hpp"
+
+#include <cstring>
+
+namespace {
+
+template <typename T>
+void run(const char* type_name, const std::uint8_t* data, std::size_t size)
+{
+    T values[4];
+    if (size < sizeof(values)) {
+        return;
+    }
+    std::memcpy(values, data, sizeof(values));
+
+    static fuzz::statistics stats;
+    fuzz::checker<T> check{type_name, stats};
+    check.abort_on_failure = true;
+
+    tcb::rational<T> a, b;
+    const bool have_a = check.construct(values[0], values[1], a);
+    const bool have_b = check.construct(values[2], values[3], b);
+    if (have_a) {
+        check.unary(a);
+    }
+    if (have_a && have_b) {
+        check.binary(a, b);
+    }
+}
+
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size)
+{
+    if (size == 0) {
+        return 0;
+    }
+    switch (data[0] % 4) {
+    case 0: run<std::int_least8_t>("rational8_t", data + 1, size - 1); break;
+    case 1: run<std::int_least16_t>("rational16_t", data + 1, size - 1); break;
+    case 2: run<std::int_least32_t>("rational32_t", data + 1, size - 1); break;
+    case 3: run<std::int_least64_t>("rational64_t", data + 1, size - 1); break;
+    }
+    return 0;
+}
@@ -0,0 +1,175 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_ATOMIC_RATIONAL_HPP_INCLUDED
+#define TCB_ATOMIC_RATIONAL_HPP_INCLUDED
+
+#include <tcb/rational.hpp>
+
+#include <atomic>
+
+namespace tcb {
+
+/*
+ * A rational which may be updated concurrently from several threads.
+ *
+ * The numerator and denominator are stored together in a single atomic
+ * object, so loads and stores never observe a torn value. Arithmetic
+ * updates are compare-and-swap loops. Rationals are always kept in
+ * canonical form, so comparing object representations (as compare-exchange
+ * does) is equivalent to comparing values.
+ *
+ * Rationals of up to 64 bits in total (rational32_t and narrower) are
+ * lock-free on all mainstream targets. rational64_t needs a 128-bit
+ * compare-and-swap: with GCC and Clang this is provided by libatomic,
+ * which uses cmpxchg16b where the CPU supports it and otherwise falls back
+ * to a lock. Programs using atomic_rational<std::int64_t> may need to link
+ * with -latomic.
+ *
+ * is_lock_free() and is_always_lock_free pass on the standard library's
+ * answer, which need not say which of these happens: GCC reports 16-byte
+ * atomics as not lock-free whatever the CPU supports, even when cmpxchg16b
+ * is used.
+ */
+template <typename T>
+class atomic_rational {
+public:
+    using value_type = rational<T>;
+
+#ifdef __cpp_lib_atomic_is_always_lock_free
+    static constexpr bool is_always_lock_free =
+            std::atomic<value_type>::is_always_lock_free;
+#endif
+
+    constexpr atomic_rational() noexcept : value_(value_type{}) {}
+
+    constexpr atomic_rational(const value_type& value) noexcept : value_(value) {}
+
+    atomic_rational(const atomic_rational&) = delete;
+
+    atomic_rational& operator=(const atomic_rational&) = delete;
+
+    bool is_lock_free() const noexcept { return value_.is_lock_free(); }
+
+    /* Loads and stores */
+
+    value_type load(std::memory_order order = std::memory_order_seq_cst) const noexcept
+    {
+        return value_.load(order);
+    }
+
+    void store(const value_type& desired,
+               std::memory_order order = std::memory_order_seq_cst) noexcept
+    {
+        value_.store(desired, order);
+    }
+
+    value_type exchange(const value_type& desired,
+                        std::memory_order order = std::memory_order_seq_cst) noexcept
+    {
+        return value_.exchange(desired, order);
+    }
+
+    bool compare_exchange_weak(value_type& expected, const value_type& desired,
+                               std::memory_order success,
+                               std::memory_order failure) noexcept
+    {
+        return value_.compare_exchange_weak(expected, desired, success, failure);
+    }
+
+    bool compare_exchange_weak(value_type& expected, const value_type& desired,
+                               std::memory_order order = std::memory_order_seq_cst) noexcept
+    {
+        return value_.compare_exchange_weak(expected, desired, order);
+    }
+
+    bool compare_exchange_strong(value_type& expected, const value_type& desired,
+                                 std::memory_order success,
+                                 std::memory_order failure) noexcept
+    {
+        return value_.compare_exchange_strong(expected, desired, success, failure);
+    }
+
+    bool compare_exchange_strong(value_type& expected, const value_type& desired,
+                                 std::memory_order order = std::memory_order_seq_cst) noexcept
+    {
+        return value_.compare_exchange_strong(expected, desired, order);
+    }
+
+    operator value_type() const noexcept { return load(); }
+
+    value_type operator=(const value_type& desired) noexcept
+    {
+        store(desired);
+        return desired;
+    }
+
+    /* Read-modify-write operations, returning the previous value */
+
+    value_type fetch_add(const value_type& arg,
+                         std::memory_order order = std::memory_order_seq_cst) noexcept
+    {
+        return update([&arg](const value_type& v) { return v + arg; }, order);
+    }
+
+    value_type fetch_sub(const value_type& arg,
+                         std::memory_order order = std::memory_order_seq_cst) noexcept
+    {
+        return update([&arg](const value_type& v) { return v - arg; }, order);
+    }
+
+    value_type fetch_mul(const value_type& arg,
+                         std::memory_order order = std::memory_order_seq_cst) noexcept
+    {
+        return update([&arg](const value_type& v) { return v * arg; }, order);
+    }
+
+    // Precondition: arg is not zero
+    value_type fetch_div(const value_type& arg,
+                         std::memory_order order = std::memory_order_seq_cst) noexcept
+    {
+        return update([&arg](const value_type& v) { return v / arg; }, order);
+    }
+
+    /* Compound assignment, returning the new value */
+
+    value_type operator+=(const value_type& arg) noexcept
+    {
+        return static_cast<value_type>(fetch_add(arg) + arg);
+    }
+
+    value_type operator-=(const value_type& arg) noexcept
+    {
+        return static_cast<value_type>(fetch_sub(arg) - arg);
+    }
+
+    value_type operator*=(const value_type& arg) noexcept
+    {
+        return static_cast<value_type>(fetch_mul(arg) * arg);
+    }
+
+    value_type operator/=(const value_type& arg) noexcept
+    {
+        return static_cast<value_type>(fetch_div(arg) / arg);
+    }
+
+private:
+    template <typename Func>
+    value_type update(Func func, std::memory_order order) noexcept
+    {
+        // The operation is recomputed from the freshly observed value each
+        // time the exchange fails
+        value_type old = value_.load(std::memory_order_relaxed);
+        while (!value_.compare_exchange_weak(old, static_cast<value_type>(func(old)),
+                                             order, std::memory_order_relaxed)) {}
+        return old;
+    }
+
+    std::atomic<value_type> value_;
+};
+
+} // end namespace tcb
+
+#endif // TCB_ATOMIC_RATIONAL_HPP_INCLUDED
@@ -0,0 +1,502 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_BIG_INTEGER_HPP_INCLUDED
+#define TCB_BIG_INTEGER_HPP_INCLUDED
+
+#include <tcb/rational.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace tcb {
+
+/*
+ * An arbitrary-precision signed integer.
+ *
+ * This is a deliberately simple implementation (schoolbook multiplication
+ * and Knuth's long division), intended for exact intermediates which would
+ * overflow a built-in type and as a reference for testing. The magnitude is
+ * stored as little-endian 32-bit limbs, with no leading zero limbs; zero has
+ * no limbs and is never negative.
+ */
+class big_integer {
+public:
+    using limb_type = std::uint32_t;
+
+    /* Construction */
+
+    big_integer() = default;
+
+    template <typename T, typename = std::enable_if_t<std::is_integral<T>::value>>
+    big_integer(T value)
+        : negative_(value < 0)
+    {
+        using unsigned_type = std::make_unsigned_t<T>;
+        auto mag = static_cast<unsigned long long>(
+                value < 0 ? static_cast<unsigned_type>(0u - static_cast<unsigned_type>(value))
+                          : static_cast<unsigned_type>(value));
+        while (mag != 0) {
+            limbs_.push_back(static_cast<limb_type>(mag));
+            mag >>= limb_digits;
+        }
+    }
+
+    /* Observers */
+
+    bool is_zero() const { return limbs_.empty(); }
+
+    bool is_negative() const { return negative_; }
+
+    // Returns -1, 0 or 1 according to the sign of the value
+    int signum() const { return is_zero() ? 0 : negative_ ? -1 : 1; }
+
+    // The number of significant bits in the magnitude
+    std::size_t bit_width() const
+    {
+        if (limbs_.empty()) {
+            return 0;
+        }
+        std::size_t width = (limbs_.size() - 1) * limb_digits;
+        for (limb_type top = limbs_.back(); top != 0; top >>= 1) {
+            ++width;
+        }
+        return width;
+    }
+
+    const std::vector<limb_type>& limbs() const { return limbs_; }
+
+    // Whether the value is representable in the integral type T
+    template <typename T>
+    bool fits() const
+    {
+        static_assert(std::is_integral<T>::value,
+                      "tcb::big_integer::fits<T>() requires an integral type");
+        if (bit_width() > static_cast<std::size_t>(
+                    std::numeric_limits<unsigned long long>::digits)) {
+            return false;
+        }
+        const unsigned long long mag = magnitude();
+        if (!negative_) {
+            return mag <= static_cast<unsigned long long>(std::numeric_limits<T>::max());
+        }
+        if (!std::is_signed<T>::value) {
+            return false;
+        }
+        // |min| == max + 1 for two's complement types
+        return mag - 1 <= static_cast<unsigned long long>(std::numeric_limits<T>::max());
+    }
+
+    /* Conversion */
+
+    // Precondition: fits<T>()
+    template <typename T, typename = std::enable_if_t<std::is_integral<T>::value>>
+    explicit operator T() const
+    {
+        const unsigned long long mag = magnitude();
+        return static_cast<T>(negative_ ? 0ull - mag : mag);
+    }
+
+    explicit operator long double() const
+    {
+        long double result = 0;
+        for (auto it = limbs_.rbegin(); it != limbs_.rend(); ++it) {
+            result = result * 4294967296.0L + *it;
+        }
+        return negative_ ? -result : result;
+    }
+
+    std::string to_string() const;
+
+    /* Compound assignment */
+
+    big_integer& operator+=(const big_integer& other)
+    {
+        if (negative_ == other.negative_) {
+            limbs_ = add_magnitudes(limbs_, other.limbs_);
+        } else if (compare_magnitudes(limbs_, other.limbs_) >= 0) {
+            limbs_ = subtract_magnitudes(limbs_, other.limbs_);
+        } else {
+            limbs_ = subtract_magnitudes(other.limbs_, limbs_);
+            negative_ = other.negative_;
+        }
+        normalize();
+        return *this;
+    }
+
+    big_integer& operator-=(const big_integer& other)
+    {
+        return *this += -other;
+    }
+
+    big_integer& operator*=(const big_integer& other)
+    {
+        limbs_ = multiply_magnitudes(limbs_, other.limbs_);
+        negative_ = negative_ != other.negative_;
+        normalize();
+        return *this;
+    }
+
+    // Truncates towards zero, as the built-in operator does.
+    // Precondition: other is not zero
+    big_integer& operator/=(const big_integer& other)
+    {
+        big_integer rem;
+        *this = divide(*this, other, rem);
+        return *this;
+    }
+
+    // The remainder takes the sign of the dividend, as the built-in
+    // operator does. Precondition: other is not zero
+    big_integer& operator%=(const big_integer& other)
+    {
+        big_integer rem;
+        divide(*this, other, rem);
+        *this = std::move(rem);
+        return *this;
+    }
+
+    big_integer operator-() const
+    {
+        big_integer result = *this;
+        result.negative_ = !result.negative_;
+        result.normalize();
+        return result;
+    }
+
+    // Computes the truncated quotient of num / denom, storing the remainder
+    // in rem. Precondition: denom is not zero
+    static big_integer divide(const big_integer& num, const big_integer& denom,
+                              big_integer& rem)
+    {
+        big_integer quot;
+        divide_magnitudes(num.limbs_, denom.limbs_, quot.limbs_, rem.limbs_);
+        quot.negative_ = num.negative_ != denom.negative_;
+        rem.negative_ = num.negative_;
+        quot.normalize();
+        rem.normalize();
+        return quot;
+    }
+
+    friend int compare(const big_integer& lhs, const big_integer& rhs)
+    {
+        if (lhs.negative_ != rhs.negative_) {
+            return lhs.negative_ ? -1 : 1;
+        }
+        const int mag_cmp = compare_magnitudes(lhs.limbs_, rhs.limbs_);
+        return lhs.negative_ ? -mag_cmp : mag_cmp;
+    }
+
+private:
+    using limbs_type = std::vector<limb_type>;
+    using wide_type = std::uint64_t;
+    using signed_wide_type = std::int64_t;
+
+    static constexpr int limb_digits = 32;
+
+    unsigned long long magnitude() const
+    {
+        unsigned long long mag = 0;
+        for (auto it = limbs_.rbegin(); it != limbs_.rend(); ++it) {
+            mag = (mag << limb_digits) | *it;
+        }
+        return mag;
+    }
+
+    void normalize()
+    {
+        while (!limbs_.empty() && limbs_.back() == 0) {
+            limbs_.pop_back();
+        }
+        if (limbs_.empty()) {
+            negative_ = false;
+        }
+    }
+
+    static int compare_magnitudes(const limbs_type& a, const limbs_type& b)
+    {
+        if (a.size() != b.size()) {
+            return a.size() < b.size() ? -1 : 1;
+        }
+        for (std::size_t i = a.size(); i-- > 0; ) {
+            if (a[i] != b[i]) {
+                return a[i] < b[i] ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+
+    static limbs_type add_magnitudes(const limbs_type& a, const limbs_type& b)
+    {
+        const limbs_type& longer = a.size() >= b.size() ? a : b;
+        const limbs_type& shorter = a.size() >= b.size() ? b : a;
+        limbs_type result(longer.size() + 1);
+        wide_type carry = 0;
+        for (std::size_t i = 0; i < longer.size(); ++i) {
+            carry += longer[i];
+            if (i < shorter.size()) {
+                carry += shorter[i];
+            }
+            result[i] = static_cast<limb_type>(carry);
+            carry >>= limb_digits;
+        }
+        result.back() = static_cast<limb_type>(carry);
+        return result;
+    }
+
+    // Precondition: |a| >= |b|
+    static limbs_type subtract_magnitudes(const limbs_type& a, const limbs_type& b)
+    {
+        limbs_type result(a.size());
+        wide_type borrow = 0;
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            const wide_type sub = borrow + (i < b.size() ? b[i] : 0);
+            result[i] = static_cast<limb_type>(a[i] - sub);
+            borrow = a[i] < sub ? 1 : 0;
+        }
+        return result;
+    }
+
+    static limbs_type multiply_magnitudes(const limbs_type& a, const limbs_type& b)
+    {
+        if (a.empty() || b.empty()) {
+            return {};
+        }
+        limbs_type result(a.size() + b.size());
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            wide_type carry = 0;
+            for (std::size_t j = 0; j < b.size(); ++j) {
+                const wide_type t = static_cast<wide_type>(a[i]) * b[j] + result[i + j] + carry;
+                result[i + j] = static_cast<limb_type>(t);
+                carry = t >> limb_digits;
+            }
+            result[i + b.size()] = static_cast<limb_type>(carry);
+        }
+        return result;
+    }
+
+    // Knuth's Algorithm D (TAOCP vol. 2, 4.3.1), following the presentation
+    // in Hacker's Delight
+    static void divide_magnitudes(const limbs_type& u, const limbs_type& v,
+                                  limbs_type& quot, limbs_type& rem)
+    {
+        if (compare_magnitudes(u, v) < 0) {
+            quot.clear();
+            rem = u;
+            return;
+        }
+
+        const std::size_t n = v.size();
+        const std::size_t m = u.size() - n;
+
+        if (n == 1) {
+            quot.assign(u.size(), 0);
+            wide_type r = 0;
+            for (std::size_t i = u.size(); i-- > 0; ) {
+                const wide_type cur = (r << limb_digits) | u[i];
+                quot[i] = static_cast<limb_type>(cur / v[0]);
+                r = cur % v[0];
+            }
+            rem.assign(1, static_cast<limb_type>(r));
+            return;
+        }
+
+        // Normalize so that the top bit of the divisor is set
+        int s = 0;
+        for (limb_type top = v.back(); (top & 0x80000000u) == 0; top <<= 1) {
+            ++s;
+        }
+        limbs_type vn(n);
+        for (std::size_t i = n - 1; i > 0; --i) {
+            vn[i] = static_cast<limb_type>((v[i] << s) |
+                                           (static_cast<wide_type>(v[i - 1]) >> (limb_digits - s)));
+        }
+        vn[0] = v[0] << s;
+
+        limbs_type un(u.size() + 1);
+        un[u.size()] = static_cast<limb_type>(static_cast<wide_type>(u.back()) >> (limb_digits - s));
+        for (std::size_t i = u.size() - 1; i > 0; --i) {
+            un[i] = static_cast<limb_type>((u[i] << s) |
+                                           (static_cast<wide_type>(u[i - 1]) >> (limb_digits - s)));
+        }
+        un[0] = u[0] << s;
+
+        const wide_type base = wide_type{1} << limb_digits;
+        quot.assign(m + 1, 0);
+        for (std::size_t j = m + 1; j-- > 0; ) {
+            // Estimate the quotient digit, and correct it to be at most one
+            // too large
+            const wide_type top = (static_cast<wide_type>(un[j + n]) << limb_digits) | un[j + n - 1];
+            wide_type qhat = top / vn[n - 1];
+            wide_type rhat = top % vn[n - 1];
+            while (qhat >= base ||
+                   qhat * vn[n - 2] > ((rhat << limb_digits) | un[j + n - 2])) {
+                --qhat;
+                rhat += vn[n - 1];
+                if (rhat >= base) {
+                    break;
+                }
+            }
+
+            // Multiply and subtract
+            signed_wide_type k = 0;
+            signed_wide_type t = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                const wide_type p = qhat * vn[i];
+                t = static_cast<signed_wide_type>(un[i + j]) - k -
+                    static_cast<signed_wide_type>(p & 0xFFFFFFFFu);
+                un[i + j] = static_cast<limb_type>(t);
+                k = static_cast<signed_wide_type>(p >> limb_digits) - (t >> limb_digits);
+            }
+            t = static_cast<signed_wide_type>(un[j + n]) - k;
+            un[j + n] = static_cast<limb_type>(t);
+
+            quot[j] = static_cast<limb_type>(qhat);
+            if (t < 0) {
+                // The estimate was one too large: add the divisor back
+                --quot[j];
+                wide_type carry = 0;
+                for (std::size_t i = 0; i < n; ++i) {
+                    const wide_type sum = static_cast<wide_type>(un[i + j]) + vn[i] + carry;
+                    un[i + j] = static_cast<limb_type>(sum);
+                    carry = sum >> limb_digits;
+                }
+                un[j + n] = static_cast<limb_type>(un[j + n] + carry);
+            }
+        }
+
+        // Unnormalize the remainder
+        rem.assign(n, 0);
+        for (std::size_t i = 0; i < n - 1; ++i) {
+            rem[i] = static_cast<limb_type>((un[i] >> s) |
+                                            (static_cast<wide_type>(un[i + 1]) << (limb_digits - s)));
+        }
+        rem[n - 1] = un[n - 1] >> s;
+    }
+
+    limbs_type limbs_;
+    bool negative_ = false;
+};
+
+/*
+ * Comparison operators
+ */
+
+inline bool operator==(const big_integer& lhs, const big_integer& rhs)
+{
+    return compare(lhs, rhs) == 0;
+}
+
+inline bool operator!=(const big_integer& lhs, const big_integer& rhs)
+{
+    return compare(lhs, rhs) != 0;
+}
+
+inline bool operator<(const big_integer& lhs, const big_integer& rhs)
+{
+    return compare(lhs, rhs) < 0;
+}
+
+inline bool operator>(const big_integer& lhs, const big_integer& rhs)
+{
+    return compare(lhs, rhs) > 0;
+}
+
+inline bool operator<=(const big_integer& lhs, const big_integer& rhs)
+{
+    return compare(lhs, rhs) <= 0;
+}
+
+inline bool operator>=(const big_integer& lhs, const big_integer& rhs)
+{
+    return compare(lhs, rhs) >= 0;
+}
+
+/*
+ * Arithmetic operators
+ */
+
+inline big_integer operator+(big_integer lhs, const big_integer& rhs)
+{
+    return lhs += rhs;
+}
+
+inline big_integer operator-(big_integer lhs, const big_integer& rhs)
+{
+    return lhs -= rhs;
+}
+
+inline big_integer operator*(big_integer lhs, const big_integer& rhs)
+{
+    return lhs *= rhs;
+}
+
+inline big_integer operator/(big_integer lhs, const big_integer& rhs)
+{
+    return lhs /= rhs;
+}
+
+inline big_integer operator%(big_integer lhs, const big_integer& rhs)
+{
+    return lhs %= rhs;
+}
+
+inline big_integer abs(const big_integer& val)
+{
+    return val.is_negative() ? -val : val;
+}
+
+// The (non-negative) greatest common divisor of a and b
+inline big_integer gcd(big_integer a, big_integer b)
+{
+#ifdef TCB_RATIONAL_GCD_HOOK
+    TCB_RATIONAL_GCD_HOOK(a, b);
+#endif
+    a = abs(a);
+    b = abs(b);
+    while (!b.is_zero()) {
+        big_integer t = a % b;
+        a = std::move(b);
+        b = std::move(t);
+    }
+    return a;
+}
+
+inline std::string big_integer::to_string() const
+{
+    if (is_zero()) {
+        return "0";
+    }
+    // Peel off nine decimal digits at a time
+    std::string digits;
+    big_integer rest = abs(*this);
+    const big_integer chunk{1000000000};
+    while (!rest.is_zero()) {
+        big_integer rem;
+        rest = divide(rest, chunk, rem);
+        auto part = static_cast<std::uint32_t>(rem);
+        for (int i = 0; i < 9 && (part != 0 || !rest.is_zero()); ++i) {
+            digits.push_back(static_cast<char>('0' + part % 10));
+            part /= 10;
+        }
+    }
+    if (negative_) {
+        digits.push_back('-');
+    }
+    std::reverse(digits.begin(), digits.end());
+    return digits;
+}
+
+#ifndef TCB_RATIONAL_NO_IOSTREAMS
+inline std::ostream& operator<<(std::ostream& os, const big_integer& val)
+{
+    return os << val.to_string();
+}
+#endif
+
+} // end namespace tcb
+
+#endif // TCB_BIG_INTEGER_HPP_INCLUDED
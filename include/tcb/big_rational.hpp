@@ -0,0 +1,203 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_BIG_RATIONAL_HPP_INCLUDED
+#define TCB_BIG_RATIONAL_HPP_INCLUDED
+
+#include <tcb/big_integer.hpp>
+
+namespace tcb {
+
+/*
+ * An arbitrary-precision rational number, always held in lowest terms with
+ * a positive denominator. This gives exact results for computations whose
+ * intermediates (or final values) would overflow rational<T>.
+ */
+class big_rational {
+public:
+    /* Construction */
+
+    big_rational() = default;
+
+    template <typename T, typename = std::enable_if_t<std::is_integral<T>::value>>
+    big_rational(T num)
+        : num_(num)
+    {}
+
+    big_rational(big_integer num)
+        : num_(std::move(num))
+    {}
+
+    // Precondition: denom is not zero
+    big_rational(big_integer num, big_integer denom)
+        : num_(std::move(num)), denom_(std::move(denom))
+    {
+        simplify();
+    }
+
+    template <typename T>
+    big_rational(const rational<T>& r)
+        : num_(r.num()), denom_(r.denom())
+    {}
+
+    /* Member access */
+
+    const big_integer& num() const { return num_; }
+
+    const big_integer& denom() const { return denom_; }
+
+    /* Conversion */
+
+    // Whether the value is representable as a rational<T>
+    template <typename T>
+    bool fits() const
+    {
+        return num_.fits<T>() && denom_.fits<T>();
+    }
+
+    // Precondition: fits<T>()
+    template <typename T>
+    explicit operator rational<T>() const
+    {
+        return rational<T>{normalized, static_cast<T>(num_), static_cast<T>(denom_)};
+    }
+
+    explicit operator long double() const
+    {
+        return static_cast<long double>(num_) / static_cast<long double>(denom_);
+    }
+
+    /* Compound assignment */
+
+    big_rational& operator+=(const big_rational& other)
+    {
+        num_ = num_ * other.denom_ + other.num_ * denom_;
+        denom_ *= other.denom_;
+        simplify();
+        return *this;
+    }
+
+    big_rational& operator-=(const big_rational& other)
+    {
+        num_ = num_ * other.denom_ - other.num_ * denom_;
+        denom_ *= other.denom_;
+        simplify();
+        return *this;
+    }
+
+    big_rational& operator*=(const big_rational& other)
+    {
+        num_ *= other.num_;
+        denom_ *= other.denom_;
+        simplify();
+        return *this;
+    }
+
+    // Precondition: other is not zero
+    big_rational& operator/=(const big_rational& other)
+    {
+        num_ *= other.denom_;
+        denom_ *= other.num_;
+        simplify();
+        return *this;
+    }
+
+    big_rational operator-() const
+    {
+        big_rational result = *this;
+        result.num_ = -result.num_;
+        return result;
+    }
+
+private:
+    void simplify()
+    {
+        if (denom_.is_negative()) {
+            num_ = -num_;
+            denom_ = -denom_;
+        }
+        const big_integer g = gcd(num_, denom_);
+        if (g != 1) {
+            num_ /= g;
+            denom_ /= g;
+        }
+    }
+
+    big_integer num_;
+    big_integer denom_ = 1;
+};
+
+/*
+ * Comparison operators
+ */
+
+inline bool operator==(const big_rational& lhs, const big_rational& rhs)
+{
+    return lhs.num() == rhs.num() && lhs.denom() == rhs.denom();
+}
+
+inline bool operator!=(const big_rational& lhs, const big_rational& rhs)
+{
+    return !(lhs == rhs);
+}
+
+inline bool operator<(const big_rational& lhs, const big_rational& rhs)
+{
+    return lhs.num() * rhs.denom() < rhs.num() * lhs.denom();
+}
+
+inline bool operator>(const big_rational& lhs, const big_rational& rhs)
+{
+    return rhs < lhs;
+}
+
+inline bool operator<=(const big_rational& lhs, const big_rational& rhs)
+{
+    return !(rhs < lhs);
+}
+
+inline bool operator>=(const big_rational& lhs, const big_rational& rhs)
+{
+    return !(lhs < rhs);
+}
+
+/*
+ * Arithmetic operators
+ */
+
+inline big_rational operator+(big_rational lhs, const big_rational& rhs)
+{
+    return lhs += rhs;
+}
+
+inline big_rational operator-(big_rational lhs, const big_rational& rhs)
+{
+    return lhs -= rhs;
+}
+
+inline big_rational operator*(big_rational lhs, const big_rational& rhs)
+{
+    return lhs *= rhs;
+}
+
+inline big_rational operator/(big_rational lhs, const big_rational& rhs)
+{
+    return lhs /= rhs;
+}
+
+#ifndef TCB_RATIONAL_NO_IOSTREAMS
+inline std::ostream& operator<<(std::ostream& os, const big_rational& r)
+{
+    os << r.num();
+    if (r.denom() != 1) {
+        os << '/' << r.denom();
+    }
+    return os;
+}
+#endif
+
+} // end namespace tcb
+
+#endif // TCB_BIG_RATIONAL_HPP_INCLUDED
@@ -0,0 +1,443 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_CONTINUED_FRACTION_HPP_INCLUDED
+#define TCB_CONTINUED_FRACTION_HPP_INCLUDED
+
+/*
+ * Lazy continued-fraction expansions of rational<T>.
+ *
+ *   views::continued_fraction(r)      the terms [a0; a1, a2, ...] of r
+ *   views::convergents(r)             the convergents p_k/q_k of r, ending
+ *                                     with r itself
+ *   views::semiconvergents(r)         every intermediate fraction
+ *                                     (p_{k-2} + j p_{k-1})/(q_{k-2} + j q_{k-1})
+ *                                     for 1 <= j <= a_k, which includes the
+ *                                     convergents
+ *
+ * The expansion is the canonical one produced by Euclid's algorithm: a0 is
+ * floor(r), the later terms are positive and the last is at least 2 unless
+ * r is an integer.
+ *
+ * Each view holds only the rational, and each iterator the state of the
+ * expansion, so nothing is allocated and the work done is proportional to
+ * the number of elements visited. Denominators of successive elements never
+ * decrease, and convergents(r, max_denom) and semiconvergents(r, max_denom)
+ * end before the first element whose denominator exceeds max_denom. Every
+ * numerator and denominator is bounded by those of r, so the expansion
+ * cannot overflow T.
+ *
+ * The views are ranges in C++20 (and borrowed ranges, as iterators do not
+ * refer to the view), so they work with the standard range algorithms and
+ * adaptors such as std::views::take_while.
+ */
+
+#include <tcb/rational.hpp>
+
+#include <cstddef>
+#include <iterator>
+#include <limits>
+
+#if defined(__has_include)
+#if __has_include(<version>)
+#include <version>
+#endif
+#endif
+
+#if defined(__cpp_lib_ranges) && __cpp_lib_ranges >= 201911
+#include <ranges>
+#define TCB_HAVE_RANGES
+#endif
+
+#ifdef TCB_HAVE_CONSTEXPR14
+#define TCB_CONSTEXPR14 constexpr
+#else
+#define TCB_CONSTEXPR14
+#endif
+
+namespace tcb {
+
+namespace detail {
+
+#ifdef TCB_HAVE_RANGES
+template <typename View>
+using view_base = std::ranges::view_interface<View>;
+#else
+template <typename View>
+struct view_base {};
+#endif
+
+// Euclid's algorithm on num/denom, yielding one continued fraction term per
+// step. denom becomes zero when the expansion is exhausted.
+template <typename T>
+struct euclid_state {
+    T num = 0;
+    T denom = 0;
+
+    constexpr bool done() const { return denom == 0; }
+
+    // Returns floor(num/denom) and replaces num/denom by the reciprocal of
+    // its fractional part
+    TCB_CONSTEXPR14 T next()
+    {
+        T term = num / denom;
+        T rem = num % denom;
+        if (rem < 0) {
+            --term;
+            rem += denom;
+        }
+        num = denom;
+        denom = rem;
+        return term;
+    }
+
+    friend constexpr bool operator==(const euclid_state& lhs, const euclid_state& rhs)
+    {
+        return lhs.num == rhs.num && lhs.denom == rhs.denom;
+    }
+};
+
+} // end namespace detail
+
+template <typename T>
+class continued_fraction_view
+    : public detail::view_base<continued_fraction_view<T>> {
+public:
+    class iterator {
+    public:
+        using value_type = T;
+        using reference = T;
+        using pointer = void;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::input_iterator_tag;
+        using iterator_concept = std::forward_iterator_tag;
+
+        constexpr iterator() = default;
+
+        TCB_CONSTEXPR14 explicit iterator(const rational<T>& r)
+            : state_{r.num(), r.denom()},
+              term_(state_.next()),
+              at_end_(false)
+        {}
+
+        constexpr T operator*() const { return term_; }
+
+        TCB_CONSTEXPR14 iterator& operator++()
+        {
+            if (state_.done()) {
+                at_end_ = true;
+            } else {
+                term_ = state_.next();
+            }
+            return *this;
+        }
+
+        TCB_CONSTEXPR14 iterator operator++(int)
+        {
+            iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend constexpr bool operator==(const iterator& lhs, const iterator& rhs)
+        {
+            return lhs.at_end_ || rhs.at_end_
+                       ? lhs.at_end_ == rhs.at_end_
+                       : lhs.state_ == rhs.state_ && lhs.term_ == rhs.term_;
+        }
+
+        friend constexpr bool operator!=(const iterator& lhs, const iterator& rhs)
+        {
+            return !(lhs == rhs);
+        }
+
+    private:
+        detail::euclid_state<T> state_{};
+        T term_ = 0;
+        bool at_end_ = true;
+    };
+
+    constexpr continued_fraction_view() = default;
+
+    constexpr explicit continued_fraction_view(const rational<T>& r) : r_(r) {}
+
+    TCB_CONSTEXPR14 iterator begin() const { return iterator{r_}; }
+
+    constexpr iterator end() const { return iterator{}; }
+
+private:
+    rational<T> r_;
+};
+
+/*
+ * The convergents are generated by the recurrences
+ *
+ *   p_k = a_k p_{k-1} + p_{k-2},   p_{-1} = 1, p_{-2} = 0
+ *   q_k = a_k q_{k-1} + q_{k-2},   q_{-1} = 0, q_{-2} = 1
+ *
+ * p_{k-1} q_{k-2} - p_{k-2} q_{k-1} = +-1, so each p_k/q_k is already in
+ * lowest terms.
+ */
+template <typename T>
+class convergents_view
+    : public detail::view_base<convergents_view<T>> {
+public:
+    class iterator {
+    public:
+        using value_type = rational<T>;
+        using reference = rational<T>;
+        using pointer = void;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::input_iterator_tag;
+        using iterator_concept = std::forward_iterator_tag;
+
+        constexpr iterator() = default;
+
+        TCB_CONSTEXPR14 iterator(const rational<T>& r, T max_denom)
+            : state_{r.num(), r.denom()},
+              p_(state_.next()),
+              max_denom_(max_denom),
+              at_end_(max_denom < 1)
+        {}
+
+        constexpr rational<T> operator*() const
+        {
+            return rational<T>{normalized, p_, q_};
+        }
+
+        TCB_CONSTEXPR14 iterator& operator++()
+        {
+            if (state_.done()) {
+                at_end_ = true;
+                return *this;
+            }
+            const T term = state_.next();
+            const T p = static_cast<T>(term * p_ + p_prev_);
+            const T q = static_cast<T>(term * q_ + q_prev_);
+            if (q > max_denom_) {
+                at_end_ = true;
+                return *this;
+            }
+            p_prev_ = p_;
+            q_prev_ = q_;
+            p_ = p;
+            q_ = q;
+            return *this;
+        }
+
+        TCB_CONSTEXPR14 iterator operator++(int)
+        {
+            iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend constexpr bool operator==(const iterator& lhs, const iterator& rhs)
+        {
+            return lhs.at_end_ || rhs.at_end_
+                       ? lhs.at_end_ == rhs.at_end_
+                       : lhs.p_ == rhs.p_ && lhs.q_ == rhs.q_;
+        }
+
+        friend constexpr bool operator!=(const iterator& lhs, const iterator& rhs)
+        {
+            return !(lhs == rhs);
+        }
+
+    private:
+        detail::euclid_state<T> state_{};
+        T p_ = 0;
+        T q_ = 1;
+        T p_prev_ = 1;
+        T q_prev_ = 0;
+        T max_denom_ = 0;
+        bool at_end_ = true;
+    };
+
+    constexpr convergents_view() = default;
+
+    constexpr explicit convergents_view(const rational<T>& r,
+                                        T max_denom = std::numeric_limits<T>::max())
+        : r_(r), max_denom_(max_denom)
+    {}
+
+    TCB_CONSTEXPR14 iterator begin() const { return iterator{r_, max_denom_}; }
+
+    constexpr iterator end() const { return iterator{}; }
+
+private:
+    rational<T> r_;
+    T max_denom_ = std::numeric_limits<T>::max();
+};
+
+/*
+ * Between the convergents p_{k-1}/q_{k-1} and p_k/q_k come the fractions
+ * (p_{k-2} + j p_{k-1})/(q_{k-2} + j q_{k-1}) for 1 <= j < a_k. Every best
+ * rational approximation of r is a convergent or one of these, although not
+ * every semiconvergent is a best approximation.
+ */
+template <typename T>
+class semiconvergents_view
+    : public detail::view_base<semiconvergents_view<T>> {
+public:
+    class iterator {
+    public:
+        using value_type = rational<T>;
+        using reference = rational<T>;
+        using pointer = void;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::input_iterator_tag;
+        using iterator_concept = std::forward_iterator_tag;
+
+        constexpr iterator() = default;
+
+        TCB_CONSTEXPR14 iterator(const rational<T>& r, T max_denom)
+            : state_{r.num(), r.denom()},
+              p_(state_.next()),
+              max_denom_(max_denom),
+              at_end_(max_denom < 1)
+        {}
+
+        constexpr rational<T> operator*() const
+        {
+            return rational<T>{normalized, p_, q_};
+        }
+
+        TCB_CONSTEXPR14 iterator& operator++()
+        {
+            if (j_ == term_) {
+                // The current element is the convergent p_k/q_k: move on to
+                // the fractions following it
+                if (state_.done()) {
+                    at_end_ = true;
+                    return *this;
+                }
+                p_prev2_ = p_prev_;
+                q_prev2_ = q_prev_;
+                p_prev_ = p_;
+                q_prev_ = q_;
+                term_ = state_.next();
+                j_ = 0;
+            }
+            ++j_;
+            p_ = static_cast<T>(p_prev2_ + j_ * p_prev_);
+            q_ = static_cast<T>(q_prev2_ + j_ * q_prev_);
+            if (q_ > max_denom_) {
+                at_end_ = true;
+            }
+            return *this;
+        }
+
+        TCB_CONSTEXPR14 iterator operator++(int)
+        {
+            iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend constexpr bool operator==(const iterator& lhs, const iterator& rhs)
+        {
+            return lhs.at_end_ || rhs.at_end_
+                       ? lhs.at_end_ == rhs.at_end_
+                       : lhs.p_ == rhs.p_ && lhs.q_ == rhs.q_;
+        }
+
+        friend constexpr bool operator!=(const iterator& lhs, const iterator& rhs)
+        {
+            return !(lhs == rhs);
+        }
+
+    private:
+        detail::euclid_state<T> state_{};
+        // The current element, and the convergents p_{k-1}/q_{k-1} and
+        // p_{k-2}/q_{k-2} either side of it. The first element is
+        // a0/1 = p_0/q_0, preceded by p_{-1}/q_{-1} = 1/0.
+        T p_ = 0;
+        T q_ = 1;
+        T p_prev_ = 1;
+        T q_prev_ = 0;
+        T p_prev2_ = 0;
+        T q_prev2_ = 1;
+        // The term a_k and the current multiple 1 <= j <= a_k of p_{k-1}
+        T term_ = 0;
+        T j_ = 0;
+        T max_denom_ = 0;
+        bool at_end_ = true;
+    };
+
+    constexpr semiconvergents_view() = default;
+
+    constexpr explicit semiconvergents_view(const rational<T>& r,
+                                            T max_denom = std::numeric_limits<T>::max())
+        : r_(r), max_denom_(max_denom)
+    {}
+
+    TCB_CONSTEXPR14 iterator begin() const { return iterator{r_, max_denom_}; }
+
+    constexpr iterator end() const { return iterator{}; }
+
+private:
+    rational<T> r_;
+    T max_denom_ = std::numeric_limits<T>::max();
+};
+
+namespace views {
+
+template <typename T>
+constexpr continued_fraction_view<T> continued_fraction(const rational<T>& r)
+{
+    return continued_fraction_view<T>{r};
+}
+
+template <typename T>
+constexpr convergents_view<T> convergents(const rational<T>& r)
+{
+    return convergents_view<T>{r};
+}
+
+// Ends before the first convergent whose denominator exceeds max_denom
+template <typename T>
+constexpr convergents_view<T> convergents(const rational<T>& r, T max_denom)
+{
+    return convergents_view<T>{r, max_denom};
+}
+
+template <typename T>
+constexpr semiconvergents_view<T> semiconvergents(const rational<T>& r)
+{
+    return semiconvergents_view<T>{r};
+}
+
+// Ends before the first semiconvergent whose denominator exceeds max_denom
+template <typename T>
+constexpr semiconvergents_view<T> semiconvergents(const rational<T>& r, T max_denom)
+{
+    return semiconvergents_view<T>{r, max_denom};
+}
+
+} // end namespace views
+
+} // end namespace tcb
+
+#ifdef TCB_HAVE_RANGES
+namespace std {
+namespace ranges {
+
+template <typename T>
+inline constexpr bool enable_borrowed_range<tcb::continued_fraction_view<T>> = true;
+
+template <typename T>
+inline constexpr bool enable_borrowed_range<tcb::convergents_view<T>> = true;
+
+template <typename T>
+inline constexpr bool enable_borrowed_range<tcb::semiconvergents_view<T>> = true;
+
+} // end namespace ranges
+} // end namespace std
+#endif
+
+#undef TCB_CONSTEXPR14
+
+#endif // TCB_CONTINUED_FRACTION_HPP_INCLUDED
@@ -0,0 +1,410 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_DIXON_SOLVER_HPP_INCLUDED
+#define TCB_DIXON_SOLVER_HPP_INCLUDED
+
+/*
+ * Exact solution of integer linear systems by p-adic lifting.
+ *
+ * Elimination over the rationals solves an n x n system in O(n^3)
+ * operations, but on entries which grow to the size of the determinant, so
+ * the bit cost grows much faster than n^3. Dixon's method (Numerische
+ * Mathematik 40, 1982) instead factors the matrix once modulo a word-sized
+ * prime p and then finds the solution's p-adic digits one at a time:
+ *
+ *   r_0 = b
+ *   x_i = A^-1 r_i (mod p)          two triangular solves, O(n^2)
+ *   r_{i+1} = (r_i - A x_i) / p     exact, and stays word-sized
+ *
+ * after which X = x_0 + x_1 p + ... + x_{k-1} p^{k-1} satisfies
+ * A X = b (mod p^k), and rational reconstruction recovers the solution.
+ * Every step works on machine words, so the cost is one O(n^3) modular
+ * factorization plus O(n^2) word operations for each digit.
+ *
+ * The number of digits is bounded using Hadamard's inequality, but the
+ * solver tries reconstruction at intervals before then, and stops as soon
+ * as the reconstructed vector y/d satisfies |A y| + |d b| < p^k: since
+ * A y = d b (mod p^k) by construction, this proves that A y = d b exactly.
+ */
+
+#include <tcb/modular.hpp>
+
+#include <cmath>
+#include <limits>
+
+namespace tcb {
+
+namespace detail {
+
+// A signed 192-bit integer in two's complement, least significant word
+// first: wide enough for a residual plus a row of the matrix times a digit
+// vector
+class lifting_residual {
+public:
+    lifting_residual() = default;
+
+    explicit lifting_residual(std::int64_t value)
+        : words_{static_cast<std::uint64_t>(value),
+                 value < 0 ? ~std::uint64_t{0} : 0,
+                 value < 0 ? ~std::uint64_t{0} : 0}
+    {}
+
+    bool is_negative() const { return (words_[2] >> 63) != 0; }
+
+    // *this -= a * b
+    void subtract_product(std::int64_t a, std::int64_t b)
+    {
+        const auto product = mul_wide(static_cast<std::uint64_t>(magnitude(a)),
+                                      static_cast<std::uint64_t>(magnitude(b)));
+        if ((a < 0) != (b < 0)) {
+            add(product.lo, product.hi);
+        } else {
+            subtract(product.lo, product.hi);
+        }
+    }
+
+    // The residue modulo d, in [0, d)
+    std::uint64_t residue(std::uint64_t d) const
+    {
+        lifting_residual copy = *this;
+        const std::uint64_t rem = copy.divide(d);
+        return is_negative() && rem != 0 ? d - rem : rem;
+    }
+
+    // Divides by d, truncating towards zero, and returns the magnitude of
+    // the remainder
+    std::uint64_t divide(std::uint64_t d)
+    {
+        const bool negative = is_negative();
+        if (negative) {
+            negate();
+        }
+        std::uint64_t rem = 0;
+        for (int i = 2; i >= 0; --i) {
+            words_[i] = div_wide(rem, words_[i], d, rem);
+        }
+        if (negative) {
+            negate();
+        }
+        return rem;
+    }
+
+private:
+    void add(std::uint64_t lo, std::uint64_t hi)
+    {
+        words_[0] += lo;
+        const std::uint64_t carry0 = words_[0] < lo ? 1 : 0;
+        const std::uint64_t mid = hi + carry0;
+        const std::uint64_t carry1 = mid < hi ? 1 : 0;
+        words_[1] += mid;
+        words_[2] += (words_[1] < mid ? 1 : 0) + carry1;
+    }
+
+    void subtract(std::uint64_t lo, std::uint64_t hi)
+    {
+        const std::uint64_t borrow0 = words_[0] < lo ? 1 : 0;
+        words_[0] -= lo;
+        const std::uint64_t mid = hi + borrow0;
+        const std::uint64_t borrow1 = mid < hi ? 1 : 0;
+        const std::uint64_t borrow2 = words_[1] < mid ? 1 : 0;
+        words_[1] -= mid;
+        words_[2] -= borrow1 + borrow2;
+    }
+
+    void negate()
+    {
+        words_[0] = ~words_[0];
+        words_[1] = ~words_[1];
+        words_[2] = ~words_[2];
+        add(1, 0);
+    }
+
+    std::uint64_t words_[3] = {0, 0, 0};
+};
+
+// An LU factorization, with partial pivoting, of a square matrix modulo a
+// prime. Entries are held in Montgomery form.
+class modular_lu {
+public:
+    // Factors the n x n row-major matrix a modulo p, returning false if it
+    // is singular modulo p
+    template <typename I>
+    bool factor(const std::vector<I>& a, std::size_t n, std::uint64_t p)
+    {
+        field_ = montgomery_modulus{p};
+        n_ = n;
+        lu_.resize(n * n);
+        for (std::size_t i = 0; i < n * n; ++i) {
+            const std::uint64_t rep = field_.to_montgomery(
+                    static_cast<std::uint64_t>(magnitude(a[i])));
+            lu_[i] = a[i] < 0 ? field_.subtract(0, rep) : rep;
+        }
+        perm_.resize(n);
+        inverse_diag_.resize(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            perm_[i] = i;
+        }
+
+        for (std::size_t k = 0; k < n; ++k) {
+            std::size_t pivot = k;
+            while (pivot < n && lu_[pivot * n + k] == 0) {
+                ++pivot;
+            }
+            if (pivot == n) {
+                return false;
+            }
+            if (pivot != k) {
+                std::swap_ranges(lu_.begin() + pivot * n, lu_.begin() + (pivot + 1) * n,
+                                 lu_.begin() + k * n);
+                std::swap(perm_[pivot], perm_[k]);
+            }
+            const std::uint64_t inverse = invert(lu_[k * n + k]);
+            inverse_diag_[k] = inverse;
+            for (std::size_t i = k + 1; i < n; ++i) {
+                std::uint64_t* row = &lu_[i * n];
+                const std::uint64_t* pivot_row = &lu_[k * n];
+                if (row[k] == 0) {
+                    continue;
+                }
+                const std::uint64_t factor = field_.multiply(row[k], inverse);
+                row[k] = factor;
+                for (std::size_t j = k + 1; j < n; ++j) {
+                    row[j] = field_.subtract(row[j], field_.multiply(factor, pivot_row[j]));
+                }
+            }
+        }
+        return true;
+    }
+
+    std::uint64_t modulus() const { return field_.modulus(); }
+
+    // Replaces the residues b by the solution of A x = b modulo p
+    void solve(std::vector<std::uint64_t>& b, std::vector<std::uint64_t>& scratch) const
+    {
+        scratch.resize(n_);
+        for (std::size_t i = 0; i < n_; ++i) {
+            scratch[i] = field_.to_montgomery(b[perm_[i]]);
+        }
+        // L y = P b, with L unit lower triangular
+        for (std::size_t i = 0; i < n_; ++i) {
+            const std::uint64_t* row = &lu_[i * n_];
+            std::uint64_t sum = scratch[i];
+            for (std::size_t j = 0; j < i; ++j) {
+                sum = field_.subtract(sum, field_.multiply(row[j], scratch[j]));
+            }
+            scratch[i] = sum;
+        }
+        // U x = y
+        for (std::size_t i = n_; i-- > 0;) {
+            const std::uint64_t* row = &lu_[i * n_];
+            std::uint64_t sum = scratch[i];
+            for (std::size_t j = i + 1; j < n_; ++j) {
+                sum = field_.subtract(sum, field_.multiply(row[j], scratch[j]));
+            }
+            scratch[i] = field_.multiply(sum, inverse_diag_[i]);
+        }
+        for (std::size_t i = 0; i < n_; ++i) {
+            b[i] = field_.from_montgomery(scratch[i]);
+        }
+    }
+
+private:
+    std::uint64_t invert(std::uint64_t rep) const
+    {
+        return field_.to_montgomery(field_.inverse_residue(field_.from_montgomery(rep)));
+    }
+
+    montgomery_modulus field_{3};
+    std::size_t n_ = 0;
+    std::vector<std::uint64_t> lu_;
+    std::vector<std::size_t> perm_;
+    std::vector<std::uint64_t> inverse_diag_;
+};
+
+// The number of p-adic digits after which reconstruction must succeed:
+// p^k > 2 max(N, D)^2, where Hadamard's inequality bounds the determinant D
+// by the product of the column norms, and Cramer's rule bounds the
+// numerators N by D ||b|| / min ||column||
+template <typename I>
+std::size_t dixon_digit_bound(const std::vector<I>& a, const std::vector<I>& b,
+                              std::size_t n, std::uint64_t p)
+{
+    using std::log2;
+    long double log_det = 0;
+    long double min_column = std::numeric_limits<long double>::infinity();
+    for (std::size_t j = 0; j < n; ++j) {
+        long double sum = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto elem = static_cast<long double>(a[i * n + j]);
+            sum += elem * elem;
+        }
+        const long double column = log2(sum) / 2;
+        log_det += column;
+        min_column = std::min(min_column, column);
+    }
+    long double b_sum = 0;
+    for (const auto elem : b) {
+        b_sum += static_cast<long double>(elem) * static_cast<long double>(elem);
+    }
+    const long double log_b = b_sum > 0 ? log2(b_sum) / 2 : 0;
+    const long double log_num = log_det - min_column + log_b;
+    const long double bits = 2 * std::max(log_num, log_det) + 2;
+    return static_cast<std::size_t>(std::ceil(bits / log2(static_cast<long double>(p)))) + 1;
+}
+
+// Reconstructs the solution from its residues modulo m, returning false if
+// any entry fails. Unless trusted, also requires the result to be proven by
+// the size bound: for the common denominator d and y = d x, any
+// A y - d b below m in magnitude is zero, as it is divisible by m.
+inline bool dixon_reconstruct(const std::vector<big_integer>& residues, const big_integer& m,
+                              std::size_t a_bits, std::size_t b_bits, bool trusted,
+                              std::vector<big_rational>& x)
+{
+    // Multiplying by the denominator so far leaves each later entry with a
+    // small denominator, so that most reconstructions finish quickly
+    std::vector<big_rational> result(residues.size());
+    big_integer denom{1};
+    for (std::size_t j = 0; j < residues.size(); ++j) {
+        big_rational scaled;
+        if (!rational_reconstruction(residues[j] * denom % m, m, scaled)) {
+            return false;
+        }
+        result[j] = big_rational{scaled.num(), scaled.denom() * denom};
+        denom *= scaled.denom();
+    }
+    if (!trusted) {
+        std::size_t y_bits = 0;
+        for (const auto& elem : result) {
+            y_bits = std::max(y_bits, (elem.num() * (denom / elem.denom())).bit_width());
+        }
+        const std::size_t bound_bits = std::max(a_bits + y_bits, denom.bit_width() + b_bits) + 1;
+        if (bound_bits + 1 > m.bit_width()) {
+            return false;
+        }
+    }
+    x = std::move(result);
+    return true;
+}
+
+template <typename I>
+std::size_t max_bit_width(const std::vector<I>& values)
+{
+    std::size_t bits = 0;
+    for (const auto elem : values) {
+        bits = std::max(bits, big_integer{elem}.bit_width());
+    }
+    return bits;
+}
+
+} // end namespace detail
+
+/*
+ * Solves the n x n system A x = b exactly, where a holds A in row-major
+ * order and n = b.size(). Returns false if A is singular.
+ *
+ * A is factored modulo the first of multimodular_primes at which it is
+ * nonsingular; a nonsingular matrix whose determinant is divisible by each
+ * of the first few primes (around 2^62 each) is reported as singular.
+ *
+ * Requires I to be an integer type no wider than 64 bits, signed if it is
+ * 64 bits wide.
+ */
+template <typename I>
+bool dixon_solve(const std::vector<I>& a, const std::vector<I>& b, std::vector<big_rational>& x)
+{
+    static_assert(std::is_integral<I>::value &&
+                  (sizeof(I) < sizeof(std::int64_t) ||
+                   (sizeof(I) == sizeof(std::int64_t) && std::is_signed<I>::value)),
+                  "dixon_solve() requires integer coefficients which fit in std::int64_t");
+    const std::size_t n = b.size();
+
+    constexpr std::size_t primes_to_try = 4;
+    const auto primes = multimodular_primes::values();
+    detail::modular_lu lu;
+    bool factored = false;
+    for (std::size_t i = 0; i < primes_to_try && !factored; ++i) {
+        factored = lu.factor(a, n, primes[i]);
+    }
+    if (!factored) {
+        return false;
+    }
+    const std::uint64_t p = lu.modulus();
+    const std::size_t max_digits = detail::dixon_digit_bound(a, b, n, p);
+    // The 1-norm of each row of A is less than n max |a_ij|
+    const std::size_t a_bits = detail::max_bit_width(a) + big_integer{n}.bit_width();
+    const std::size_t b_bits = detail::max_bit_width(b);
+
+    std::vector<detail::lifting_residual> residual(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        residual[i] = detail::lifting_residual{static_cast<std::int64_t>(b[i])};
+    }
+    std::vector<std::uint64_t> digits(n);
+    std::vector<std::int64_t> signed_digits(n);
+    std::vector<std::uint64_t> scratch;
+    std::vector<big_integer> sum(n);
+    big_integer power{1};
+    std::size_t checkpoint = 2;
+
+    for (std::size_t k = 1;; ++k) {
+        for (std::size_t i = 0; i < n; ++i) {
+            digits[i] = residual[i].residue(p);
+        }
+        lu.solve(digits, scratch);
+        // Digits in (-p/2, p/2) keep the residual small
+        for (std::size_t j = 0; j < n; ++j) {
+            signed_digits[j] = digits[j] > p / 2 ? -static_cast<std::int64_t>(p - digits[j])
+                                                 : static_cast<std::int64_t>(digits[j]);
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            const I* row = &a[i * n];
+            for (std::size_t j = 0; j < n; ++j) {
+                residual[i].subtract_product(static_cast<std::int64_t>(row[j]), signed_digits[j]);
+            }
+            residual[i].divide(p);
+        }
+        for (std::size_t j = 0; j < n; ++j) {
+            sum[j] += power * big_integer{signed_digits[j]};
+        }
+        power *= big_integer{p};
+
+        if (k == max_digits || k == checkpoint) {
+            if (detail::dixon_reconstruct(sum, power, a_bits, b_bits, k == max_digits, x)) {
+                return true;
+            }
+            if (k == max_digits) {
+                return false;
+            }
+            checkpoint = k + std::max<std::size_t>(1, k / 4);
+        }
+    }
+}
+
+/*
+ * As above, converting the solution to rational<T>. Returns false if A is
+ * singular or any entry of the solution does not fit in rational<T>.
+ */
+template <typename I, typename T>
+bool dixon_solve(const std::vector<I>& a, const std::vector<I>& b, std::vector<rational<T>>& x)
+{
+    std::vector<big_rational> exact;
+    if (!dixon_solve(a, b, exact)) {
+        return false;
+    }
+    for (const auto& elem : exact) {
+        if (!elem.fits<T>()) {
+            return false;
+        }
+    }
+    x.clear();
+    for (const auto& elem : exact) {
+        x.push_back(static_cast<rational<T>>(elem));
+    }
+    return true;
+}
+
+} // end namespace tcb
+
+#endif // TCB_DIXON_SOLVER_HPP_INCLUDED
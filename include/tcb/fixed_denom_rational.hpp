@@ -0,0 +1,326 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_FIXED_DENOM_RATIONAL_HPP_INCLUDED
+#define TCB_FIXED_DENOM_RATIONAL_HPP_INCLUDED
+
+#include <tcb/rational.hpp>
+
+#ifdef TCB_HAVE_CONSTEXPR14
+#define TCB_CONSTEXPR14 constexpr
+#else
+#define TCB_CONSTEXPR14
+#endif
+
+namespace tcb {
+
+namespace detail {
+
+// a * b / c, truncated towards zero, with the product formed at twice the
+// width of T so that it cannot overflow. Requires c != 0 and the quotient
+// to fit in T.
+template <typename T>
+TCB_CONSTEXPR14 std::enable_if_t<(sizeof(next_wider_t<T>) > sizeof(T)), T>
+fixed_mul_div(T a, T b, T c)
+{
+    return static_cast<T>(static_cast<next_wider_t<T>>(a) * b / c);
+}
+
+template <typename T>
+constexpr std::uint64_t fixed_magnitude(T value)
+{
+    return value < 0 ? std::uint64_t{0} - static_cast<std::uint64_t>(value)
+                     : static_cast<std::uint64_t>(value);
+}
+
+// For 64-bit T there is no wider built-in type, so multiply and divide the
+// magnitudes as double words. The divisor is only known at run time, so
+// this is a full double-word division.
+template <typename T>
+TCB_CONSTEXPR14 std::enable_if_t<(sizeof(next_wider_t<T>) == sizeof(T)), T>
+fixed_mul_div(T a, T b, T c)
+{
+    const bool negative = ((a < 0) != (b < 0)) != (c < 0);
+    const auto p = mul_wide(fixed_magnitude(a), fixed_magnitude(b));
+    std::uint64_t rem = 0;
+    const std::uint64_t q = div_wide(p.hi, p.lo, fixed_magnitude(c), rem);
+    return static_cast<T>(negative ? std::uint64_t{0} - q : q);
+}
+
+// a * b / C for a positive constant C, as fixed_mul_div(). The division is
+// by a constant, so the compiler emits a multiply and shift rather than a
+// divide...
+template <typename T, T C>
+TCB_CONSTEXPR14 std::enable_if_t<(sizeof(next_wider_t<T>) > sizeof(T)), T>
+fixed_mul_div_by(T a, T b)
+{
+    return static_cast<T>(static_cast<next_wider_t<T>>(a) * b / C);
+}
+
+// ...but not of a double word, so use a reciprocal computed at compile time
+// instead
+template <typename T, T C>
+TCB_CONSTEXPR14 std::enable_if_t<(sizeof(next_wider_t<T>) == sizeof(T)), T>
+fixed_mul_div_by(T a, T b)
+{
+    constexpr invariant_divider<std::uint64_t> divider(fixed_magnitude(C));
+    const bool negative = (a < 0) != (b < 0);
+    const auto p = mul_wide(fixed_magnitude(a), fixed_magnitude(b));
+    std::uint64_t rem = 0;
+    const std::uint64_t q = divider.divide(p.hi, p.lo, rem);
+    return static_cast<T>(negative ? std::uint64_t{0} - q : q);
+}
+
+} // end namespace detail
+
+/*
+ * A rational number whose denominator is the compile-time constant Denom.
+ *
+ * Only the numerator is stored, so addition, subtraction and comparison are
+ * plain integer operations. Values are not reduced: 45000/90000 is stored as
+ * 45000. Operations whose exact result is not a multiple of 1/Denom
+ * (multiplication and division of two values, or division by an integer)
+ * truncate towards zero, as fixed-point arithmetic does. Convert to
+ * rational<T> for exact results.
+ */
+template <typename T, T Denom>
+class fixed_denom_rational {
+public:
+    static_assert(std::is_integral<T>::value,
+                  "tcb::fixed_denom_rational<T, Denom> requires T to be an integral type");
+    static_assert(Denom > 0,
+                  "tcb::fixed_denom_rational<T, Denom> requires a positive denominator");
+
+    using value_type = T;
+
+    // The unit in which the numerator counts, e.g. for use with std::chrono
+    using period = std::ratio<1, Denom>;
+
+    /* Construction */
+
+    constexpr fixed_denom_rational() = default;
+
+    template <typename U, typename = std::enable_if_t<std::is_integral<U>::value>>
+    constexpr fixed_denom_rational(U value)
+        : num_(static_cast<value_type>(value * Denom))
+    {}
+
+    // Exact by construction: the ratio's denominator must divide Denom
+    template <std::intmax_t Num, std::intmax_t Den>
+    constexpr fixed_denom_rational(std::ratio<Num, Den>)
+        : num_(static_cast<value_type>(std::ratio<Num, Den>::num *
+                                       (Denom / std::ratio<Num, Den>::den)))
+    {
+        static_assert(Denom % std::ratio<Num, Den>::den == 0,
+                      "std::ratio is not representable with this denominator");
+    }
+
+    // Exact if r.denom() divides Denom, otherwise truncates towards zero
+    template <typename U>
+    constexpr explicit fixed_denom_rational(const rational<U>& r)
+        : num_(static_cast<value_type>(detail::fixed_mul_div<detail::wider_of_t<T, U>>(
+                  r.num(), Denom, r.denom())))
+    {}
+
+    static TCB_CONSTEXPR14 fixed_denom_rational from_num(value_type num)
+    {
+        fixed_denom_rational f;
+        f.num_ = num;
+        return f;
+    }
+
+    /* Member access */
+
+    constexpr value_type num() const { return num_; }
+
+    static constexpr value_type denom() { return Denom; }
+
+    /* Compound assignment */
+
+    TCB_CONSTEXPR14 fixed_denom_rational& operator+=(const fixed_denom_rational& other)
+    {
+        num_ += other.num_;
+        return *this;
+    }
+
+    TCB_CONSTEXPR14 fixed_denom_rational& operator-=(const fixed_denom_rational& other)
+    {
+        num_ -= other.num_;
+        return *this;
+    }
+
+    // (a/D) * (b/D) == (a*b/D)/D: the division is by a constant, so it
+    // becomes a multiplication by a reciprocal rather than a divide
+    TCB_CONSTEXPR14 fixed_denom_rational& operator*=(const fixed_denom_rational& other)
+    {
+        num_ = detail::fixed_mul_div_by<value_type, Denom>(num_, other.num_);
+        return *this;
+    }
+
+    template <typename U,
+              typename = std::enable_if_t<std::is_integral<U>::value>>
+    TCB_CONSTEXPR14 fixed_denom_rational& operator*=(U other)
+    {
+        num_ *= other;
+        return *this;
+    }
+
+    TCB_CONSTEXPR14 fixed_denom_rational& operator/=(const fixed_denom_rational& other)
+    {
+        num_ = detail::fixed_mul_div<value_type>(num_, Denom, other.num_);
+        return *this;
+    }
+
+    template <typename U,
+              typename = std::enable_if_t<std::is_integral<U>::value>>
+    TCB_CONSTEXPR14 fixed_denom_rational& operator/=(U other)
+    {
+        num_ /= other;
+        return *this;
+    }
+
+    /* Conversion */
+
+    TCB_CONSTEXPR14 operator rational<value_type>() const
+    {
+        return rational<value_type>{num_, Denom};
+    }
+
+    constexpr explicit operator long double() const
+    {
+        return num_/static_cast<long double>(Denom);
+    }
+
+private:
+    value_type num_ = 0;
+};
+
+/*
+ * Comparison operators
+ */
+
+template <typename T, T D>
+constexpr bool operator==(const fixed_denom_rational<T, D>& lhs,
+                          const fixed_denom_rational<T, D>& rhs)
+{
+    return lhs.num() == rhs.num();
+}
+
+template <typename T, T D>
+constexpr bool operator!=(const fixed_denom_rational<T, D>& lhs,
+                          const fixed_denom_rational<T, D>& rhs)
+{
+    return lhs.num() != rhs.num();
+}
+
+template <typename T, T D>
+constexpr bool operator<(const fixed_denom_rational<T, D>& lhs,
+                         const fixed_denom_rational<T, D>& rhs)
+{
+    return lhs.num() < rhs.num();
+}
+
+template <typename T, T D>
+constexpr bool operator>(const fixed_denom_rational<T, D>& lhs,
+                         const fixed_denom_rational<T, D>& rhs)
+{
+    return lhs.num() > rhs.num();
+}
+
+template <typename T, T D>
+constexpr bool operator<=(const fixed_denom_rational<T, D>& lhs,
+                          const fixed_denom_rational<T, D>& rhs)
+{
+    return lhs.num() <= rhs.num();
+}
+
+template <typename T, T D>
+constexpr bool operator>=(const fixed_denom_rational<T, D>& lhs,
+                          const fixed_denom_rational<T, D>& rhs)
+{
+    return lhs.num() >= rhs.num();
+}
+
+/*
+ * Arithmetic operators
+ */
+
+template <typename T, T D>
+constexpr fixed_denom_rational<T, D> operator+(const fixed_denom_rational<T, D>& f)
+{
+    return f;
+}
+
+template <typename T, T D>
+TCB_CONSTEXPR14 fixed_denom_rational<T, D> operator-(const fixed_denom_rational<T, D>& f)
+{
+    return fixed_denom_rational<T, D>::from_num(static_cast<T>(-f.num()));
+}
+
+template <typename T, T D>
+TCB_CONSTEXPR14 fixed_denom_rational<T, D>
+operator+(fixed_denom_rational<T, D> lhs, const fixed_denom_rational<T, D>& rhs)
+{
+    return lhs += rhs;
+}
+
+template <typename T, T D>
+TCB_CONSTEXPR14 fixed_denom_rational<T, D>
+operator-(fixed_denom_rational<T, D> lhs, const fixed_denom_rational<T, D>& rhs)
+{
+    return lhs -= rhs;
+}
+
+template <typename T, T D>
+TCB_CONSTEXPR14 fixed_denom_rational<T, D>
+operator*(fixed_denom_rational<T, D> lhs, const fixed_denom_rational<T, D>& rhs)
+{
+    return lhs *= rhs;
+}
+
+template <typename T, T D, typename U,
+          typename = std::enable_if_t<std::is_integral<U>::value>>
+TCB_CONSTEXPR14 fixed_denom_rational<T, D>
+operator*(fixed_denom_rational<T, D> lhs, U rhs)
+{
+    return lhs *= rhs;
+}
+
+template <typename T, T D, typename U,
+          typename = std::enable_if_t<std::is_integral<U>::value>>
+TCB_CONSTEXPR14 fixed_denom_rational<T, D>
+operator*(U lhs, fixed_denom_rational<T, D> rhs)
+{
+    return rhs *= lhs;
+}
+
+template <typename T, T D>
+TCB_CONSTEXPR14 fixed_denom_rational<T, D>
+operator/(fixed_denom_rational<T, D> lhs, const fixed_denom_rational<T, D>& rhs)
+{
+    return lhs /= rhs;
+}
+
+template <typename T, T D, typename U,
+          typename = std::enable_if_t<std::is_integral<U>::value>>
+TCB_CONSTEXPR14 fixed_denom_rational<T, D>
+operator/(fixed_denom_rational<T, D> lhs, U rhs)
+{
+    return lhs /= rhs;
+}
+
+#ifndef TCB_RATIONAL_NO_IOSTREAMS
+template <typename T, T D>
+std::ostream& operator<<(std::ostream& os, const fixed_denom_rational<T, D>& f)
+{
+    return os << static_cast<rational<T>>(f);
+}
+#endif
+
+} // end namespace tcb
+
+#undef TCB_CONSTEXPR14
+
+#endif // TCB_FIXED_DENOM_RATIONAL_HPP_INCLUDED
@@ -0,0 +1,533 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_MODULAR_HPP_INCLUDED
+#define TCB_MODULAR_HPP_INCLUDED
+
+/*
+ * Multi-modular arithmetic.
+ *
+ * An exact rational computation whose intermediates grow large can often be
+ * done more cheaply by running it in several prime fields, where every
+ * value is a single word, and recovering the rational result afterwards:
+ *
+ *   modular_rational<P>        an element of the integers modulo the odd
+ *                              prime P < 2^63, held in Montgomery form so
+ *                              that a product costs two wide multiplies
+ *                              and no division
+ *   rational_reconstruction()  the rational n/d with small n and d which is
+ *                              congruent to a residue modulo m
+ *   multimodular()             runs a computation modulo a series of 62-bit
+ *                              primes, several at once on separate threads,
+ *                              combines the residues by the Chinese
+ *                              remainder theorem and reconstructs the
+ *                              rational results, stopping as soon as they
+ *                              are the same for two successive primes
+ *
+ * Reconstruction succeeds once the product of the primes exceeds
+ * 2 max(|n|, d)^2 for every result n/d, so the number of primes needed
+ * grows with the size of the answer rather than with the size of the
+ * intermediates.
+ */
+
+#include <tcb/big_rational.hpp>
+#include <tcb/rescale.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#ifdef TCB_HAVE_CONSTEXPR14
+#define TCB_CONSTEXPR14 constexpr
+#else
+#define TCB_CONSTEXPR14
+#endif
+
+namespace tcb {
+
+/*
+ * Montgomery arithmetic modulo an odd p < 2^63, with R = 2^64. A residue x
+ * is represented by x R mod p, so that the product of two representations
+ * a R and b R reduces to a b R by the REDC step (t + m p)/R, where
+ * m = -t p^-1 mod R makes the division exact.
+ *
+ * Representations are kept in [0, p), and p < 2^63 ensures that sums of
+ * two of them do not overflow.
+ */
+class montgomery_modulus {
+public:
+    // Requires p odd and 1 < p < 2^63
+    constexpr explicit montgomery_modulus(std::uint64_t p)
+        : p_(p), neg_inv_(negated_inverse(p)), r2_(power_of_two_mod(128, p))
+    {}
+
+    constexpr std::uint64_t modulus() const { return p_; }
+
+    // t / R mod p, for t < p R
+    TCB_CONSTEXPR14 std::uint64_t reduce(detail::double_word<std::uint64_t> t) const
+    {
+        const std::uint64_t m = t.lo * neg_inv_;
+        const auto mp = detail::mul_wide(m, p_);
+        // t.lo + mp.lo is zero modulo 2^64, carrying exactly when t.lo != 0
+        const std::uint64_t carry = t.lo != 0 ? 1 : 0;
+        const std::uint64_t result = t.hi + mp.hi + carry;
+        return result >= p_ ? result - p_ : result;
+    }
+
+    TCB_CONSTEXPR14 std::uint64_t multiply(std::uint64_t a, std::uint64_t b) const
+    {
+        return reduce(detail::mul_wide(a, b));
+    }
+
+    TCB_CONSTEXPR14 std::uint64_t add(std::uint64_t a, std::uint64_t b) const
+    {
+        const std::uint64_t sum = a + b;
+        return sum >= p_ ? sum - p_ : sum;
+    }
+
+    TCB_CONSTEXPR14 std::uint64_t subtract(std::uint64_t a, std::uint64_t b) const
+    {
+        return a >= b ? a - b : a + (p_ - b);
+    }
+
+    // The representation of x, for any x
+    TCB_CONSTEXPR14 std::uint64_t to_montgomery(std::uint64_t x) const
+    {
+        return multiply(x % p_, r2_);
+    }
+
+    // The residue in [0, p) represented by x
+    TCB_CONSTEXPR14 std::uint64_t from_montgomery(std::uint64_t x) const
+    {
+        return reduce({0, x});
+    }
+
+    // The inverse of the residue x in [1, p), which must be coprime to p
+    TCB_CONSTEXPR14 std::uint64_t inverse_residue(std::uint64_t x) const
+    {
+        // Extended Euclid, tracking only the coefficient of x. Every value
+        // is less than p < 2^63, so fits in a signed word.
+        std::int64_t r0 = static_cast<std::int64_t>(p_), r1 = static_cast<std::int64_t>(x);
+        std::int64_t t0 = 0, t1 = 1;
+        while (r1 != 0) {
+            const std::int64_t q = r0 / r1;
+            std::int64_t tmp = r0 - q * r1;
+            r0 = r1;
+            r1 = tmp;
+            tmp = t0 - q * t1;
+            t0 = t1;
+            t1 = tmp;
+        }
+        return t0 < 0 ? static_cast<std::uint64_t>(t0 + static_cast<std::int64_t>(p_))
+                      : static_cast<std::uint64_t>(t0);
+    }
+
+private:
+    // -p^-1 mod 2^64 by Newton's iteration, each step doubling the number of
+    // correct low bits (p is its own inverse modulo 8)
+    static constexpr std::uint64_t negated_inverse(std::uint64_t p)
+    {
+        return 0 - inverse_step(inverse_step(inverse_step(inverse_step(inverse_step(p, p), p), p), p), p);
+    }
+
+    static constexpr std::uint64_t inverse_step(std::uint64_t inv, std::uint64_t p)
+    {
+        return inv * (2 - p * inv);
+    }
+
+    // 2^n mod p by doubling
+    static TCB_CONSTEXPR14 std::uint64_t power_of_two_mod(int n, std::uint64_t p)
+    {
+        std::uint64_t x = 1 % p;
+        for (int i = 0; i < n; ++i) {
+            x <<= 1;
+            if (x >= p) {
+                x -= p;
+            }
+        }
+        return x;
+    }
+
+    std::uint64_t p_;
+    std::uint64_t neg_inv_;
+    std::uint64_t r2_;
+};
+
+namespace detail {
+
+// One copy of the constants per modulus, computed at compile time
+template <std::uint64_t P>
+constexpr montgomery_modulus montgomery_constants{P};
+
+} // end namespace detail
+
+/*
+ * The image of a rational number in the field of integers modulo P.
+ *
+ * Conversions from integers reduce them modulo P, and conversions from
+ * rationals multiply the numerator by the inverse of the denominator, which
+ * must not be divisible by P.
+ */
+template <std::uint64_t P>
+class modular_rational {
+    static_assert(P % 2 == 1 && P > 2 && P < (std::uint64_t{1} << 63),
+                  "modular_rational requires an odd prime modulus below 2^63");
+
+public:
+    static constexpr std::uint64_t modulus = P;
+
+    constexpr modular_rational() = default;
+
+    template <typename I, typename = std::enable_if_t<std::is_integral<I>::value>>
+    TCB_CONSTEXPR14 modular_rational(I value)
+        : rep_(from_integer(value))
+    {}
+
+    template <typename T>
+    TCB_CONSTEXPR14 modular_rational(const rational<T>& r)
+        : rep_(field().multiply(from_integer(r.num()),
+                                inverse_rep(from_integer(r.denom()))))
+    {}
+
+    explicit modular_rational(const big_integer& value)
+        : rep_(from_big_integer(value))
+    {}
+
+    explicit modular_rational(const big_rational& r)
+        : rep_(field().multiply(from_big_integer(r.num()),
+                                inverse_rep(from_big_integer(r.denom()))))
+    {}
+
+    // The residue in [0, P)
+    TCB_CONSTEXPR14 std::uint64_t value() const { return field().from_montgomery(rep_); }
+
+    constexpr bool is_zero() const { return rep_ == 0; }
+
+    // Requires a non-zero value
+    TCB_CONSTEXPR14 modular_rational inverse() const
+    {
+        return from_rep(inverse_rep(rep_));
+    }
+
+    TCB_CONSTEXPR14 modular_rational& operator+=(const modular_rational& other)
+    {
+        rep_ = field().add(rep_, other.rep_);
+        return *this;
+    }
+
+    TCB_CONSTEXPR14 modular_rational& operator-=(const modular_rational& other)
+    {
+        rep_ = field().subtract(rep_, other.rep_);
+        return *this;
+    }
+
+    TCB_CONSTEXPR14 modular_rational& operator*=(const modular_rational& other)
+    {
+        rep_ = field().multiply(rep_, other.rep_);
+        return *this;
+    }
+
+    // Requires a non-zero divisor
+    TCB_CONSTEXPR14 modular_rational& operator/=(const modular_rational& other)
+    {
+        rep_ = field().multiply(rep_, inverse_rep(other.rep_));
+        return *this;
+    }
+
+    friend TCB_CONSTEXPR14 modular_rational operator-(const modular_rational& x)
+    {
+        return from_rep(field().subtract(0, x.rep_));
+    }
+
+    friend TCB_CONSTEXPR14 modular_rational operator+(modular_rational lhs, const modular_rational& rhs)
+    {
+        return lhs += rhs;
+    }
+
+    friend TCB_CONSTEXPR14 modular_rational operator-(modular_rational lhs, const modular_rational& rhs)
+    {
+        return lhs -= rhs;
+    }
+
+    friend TCB_CONSTEXPR14 modular_rational operator*(modular_rational lhs, const modular_rational& rhs)
+    {
+        return lhs *= rhs;
+    }
+
+    friend TCB_CONSTEXPR14 modular_rational operator/(modular_rational lhs, const modular_rational& rhs)
+    {
+        return lhs /= rhs;
+    }
+
+    friend constexpr bool operator==(const modular_rational& lhs, const modular_rational& rhs)
+    {
+        return lhs.rep_ == rhs.rep_;
+    }
+
+    friend constexpr bool operator!=(const modular_rational& lhs, const modular_rational& rhs)
+    {
+        return lhs.rep_ != rhs.rep_;
+    }
+
+    // x^n, by repeated squaring
+    friend TCB_CONSTEXPR14 modular_rational pow(modular_rational x, std::uint64_t n)
+    {
+        modular_rational result{1};
+        for (; n != 0; n >>= 1) {
+            if (n & 1) {
+                result *= x;
+            }
+            x *= x;
+        }
+        return result;
+    }
+
+private:
+    static constexpr const montgomery_modulus& field()
+    {
+        return detail::montgomery_constants<P>;
+    }
+
+    static constexpr modular_rational from_rep(std::uint64_t rep)
+    {
+        modular_rational result;
+        result.rep_ = rep;
+        return result;
+    }
+
+    template <typename I>
+    static TCB_CONSTEXPR14 std::uint64_t from_integer(I value)
+    {
+        const std::uint64_t rep = field().to_montgomery(
+                static_cast<std::uint64_t>(detail::magnitude(value)));
+        return value < 0 ? field().subtract(0, rep) : rep;
+    }
+
+    static std::uint64_t from_big_integer(const big_integer& value)
+    {
+        big_integer rem = value % big_integer{P};
+        if (rem.is_negative()) {
+            rem += big_integer{P};
+        }
+        return field().to_montgomery(static_cast<std::uint64_t>(rem));
+    }
+
+    static TCB_CONSTEXPR14 std::uint64_t inverse_rep(std::uint64_t rep)
+    {
+        // (x R)^-1 R^2 = x^-1 R, where from_montgomery() gives x and
+        // to_montgomery() restores the factor of R
+        return field().to_montgomery(field().inverse_residue(field().from_montgomery(rep)));
+    }
+
+    std::uint64_t rep_ = 0;
+};
+
+/*
+ * Finds the rational n/d with 2 n^2 < m and 0 < 2 d^2 < m for which
+ * n = residue d (mod m), which is unique if it exists, returning false if
+ * there is none.
+ *
+ * This is Wang's algorithm: the extended Euclidean algorithm on m and the
+ * residue, tracking only the coefficient of the residue, stops at the first
+ * remainder small enough to be n, and the coefficient is then d.
+ */
+inline bool rational_reconstruction(const big_integer& residue, const big_integer& m,
+                                    big_rational& result)
+{
+    big_integer r0 = m;
+    big_integer r1 = residue % m;
+    if (r1.is_negative()) {
+        r1 += m;
+    }
+    big_integer t0{0};
+    big_integer t1{1};
+    const big_integer two{2};
+    while (two * r1 * r1 >= m) {
+        big_integer rem;
+        const big_integer q = big_integer::divide(r0, r1, rem);
+        r0 = std::move(r1);
+        r1 = std::move(rem);
+        big_integer t = t0 - q * t1;
+        t0 = std::move(t1);
+        t1 = std::move(t);
+    }
+    if (two * t1 * t1 >= m || gcd(r1, t1) != big_integer{1}) {
+        return false;
+    }
+    result = big_rational{t1.is_negative() ? -r1 : r1, abs(t1)};
+    return true;
+}
+
+/*
+ * The primes used by multimodular(): the sixteen largest below 2^62.
+ */
+template <std::uint64_t... Primes>
+struct prime_list {
+    static constexpr std::size_t size = sizeof...(Primes);
+
+    static constexpr std::array<std::uint64_t, sizeof...(Primes)> values()
+    {
+        return {{Primes...}};
+    }
+};
+
+using multimodular_primes = prime_list<
+        (std::uint64_t{1} << 62) - 57, (std::uint64_t{1} << 62) - 87,
+        (std::uint64_t{1} << 62) - 117, (std::uint64_t{1} << 62) - 143,
+        (std::uint64_t{1} << 62) - 153, (std::uint64_t{1} << 62) - 167,
+        (std::uint64_t{1} << 62) - 171, (std::uint64_t{1} << 62) - 195,
+        (std::uint64_t{1} << 62) - 203, (std::uint64_t{1} << 62) - 273,
+        (std::uint64_t{1} << 62) - 287, (std::uint64_t{1} << 62) - 317,
+        (std::uint64_t{1} << 62) - 443, (std::uint64_t{1} << 62) - 483,
+        (std::uint64_t{1} << 62) - 495, (std::uint64_t{1} << 62) - 575>;
+
+struct multimodular_options {
+    // The most primes to use, up to multimodular_primes::size (62 bits each)
+    std::size_t max_primes = multimodular_primes::size;
+    // The number of primes computed at once, each on its own thread, at most
+    // max_primes. Zero means std::thread::hardware_concurrency().
+    std::size_t threads = 0;
+};
+
+namespace detail {
+
+// A prime P, with a function which runs the computation in its field and
+// returns the residues of the results
+struct modular_task {
+    std::uint64_t prime;
+    std::function<bool(std::vector<std::uint64_t>&)> run;
+};
+
+template <typename Func, std::uint64_t... Primes>
+std::vector<modular_task> make_modular_tasks(Func& func, prime_list<Primes...>)
+{
+    return {modular_task{Primes, [&func](std::vector<std::uint64_t>& residues) {
+        using field_type = modular_rational<Primes>;
+        std::vector<field_type> images;
+        if (!func(field_type{}, images)) {
+            return false;
+        }
+        residues.resize(images.size());
+        for (std::size_t i = 0; i < images.size(); ++i) {
+            residues[i] = images[i].value();
+        }
+        return true;
+    }}...};
+}
+
+// Updates x modulo m to the value congruent to both x (mod m) and
+// residue (mod p), by Garner's formula x + m ((residue - x) m^-1 mod p)
+inline void crt_combine(big_integer& x, const big_integer& m, std::uint64_t residue,
+                        const montgomery_modulus& field, std::uint64_t m_inverse)
+{
+    const auto x_mod_p = static_cast<std::uint64_t>(x % big_integer{field.modulus()});
+    const std::uint64_t diff = field.subtract(field.to_montgomery(residue),
+                                              field.to_montgomery(x_mod_p));
+    const std::uint64_t k = field.from_montgomery(field.multiply(diff, m_inverse));
+    x += m * big_integer{k};
+}
+
+} // end namespace detail
+
+/*
+ * Computes a vector of rationals by running func modulo several primes.
+ *
+ * func is called as func(F{}, out) for F = modular_rational<P>, and should
+ * store the images modulo P of the results in out (a std::vector<F>) and
+ * return true, or return false if P is unlucky for the computation (for
+ * example, if a pivot vanishes modulo P). It is called concurrently from
+ * several threads, so must be safe to run in parallel with itself; a
+ * generic lambda is typical:
+ *
+ *   multimodular([&](auto zero, auto& out) {
+ *       using F = decltype(zero);
+ *       ...
+ *   }, results);
+ *
+ * Primes are computed options.threads at a time, after which the residues
+ * of each are combined in turn and the results reconstructed. Returns true
+ * once every result is the same for two successive (lucky) primes, or
+ * false if that has not happened by the time the primes run out (or func
+ * returned results of different lengths).
+ */
+template <typename Func>
+bool multimodular(Func func, std::vector<big_rational>& results,
+                  const multimodular_options& options = {})
+{
+    const auto tasks = detail::make_modular_tasks(func, multimodular_primes{});
+    const std::size_t max_primes = std::min(options.max_primes, tasks.size());
+    std::size_t threads = options.threads != 0 ? options.threads
+                                               : std::thread::hardware_concurrency();
+    // More threads than primes would leave nothing to confirm against
+    threads = std::max<std::size_t>(std::min(threads, max_primes), 1);
+
+    big_integer modulus{1};
+    std::vector<big_integer> combined;
+    bool have_combined = false;
+    std::vector<big_rational> previous;
+    bool have_previous = false;
+
+    for (std::size_t start = 0; start < max_primes; start += threads) {
+        const std::size_t count = std::min(threads, max_primes - start);
+        std::vector<std::vector<std::uint64_t>> residues(count);
+        std::vector<char> lucky(count);
+        if (count == 1) {
+            lucky[0] = tasks[start].run(residues[0]);
+        } else {
+            std::vector<std::thread> workers;
+            for (std::size_t i = 0; i < count; ++i) {
+                workers.emplace_back([&, i] { lucky[i] = tasks[start + i].run(residues[i]); });
+            }
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        }
+
+        for (std::size_t i = 0; i < count; ++i) {
+            if (!lucky[i]) {
+                continue;
+            }
+            if (!have_combined) {
+                combined.assign(residues[i].begin(), residues[i].end());
+                have_combined = true;
+            } else {
+                if (residues[i].size() != combined.size()) {
+                    return false;
+                }
+                const montgomery_modulus field{tasks[start + i].prime};
+                const auto m_mod_p = static_cast<std::uint64_t>(modulus % big_integer{field.modulus()});
+                const std::uint64_t m_inverse = field.to_montgomery(field.inverse_residue(m_mod_p));
+                for (std::size_t j = 0; j < combined.size(); ++j) {
+                    detail::crt_combine(combined[j], modulus, residues[i][j], field, m_inverse);
+                }
+            }
+            modulus *= big_integer{tasks[start + i].prime};
+
+            // Reconstruct after every prime rather than every round, so
+            // that a round can confirm its own results
+            std::vector<big_rational> current(combined.size());
+            bool reconstructed = true;
+            for (std::size_t j = 0; j < combined.size() && reconstructed; ++j) {
+                reconstructed = rational_reconstruction(combined[j], modulus, current[j]);
+            }
+            if (reconstructed && have_previous && current == previous) {
+                results = std::move(current);
+                return true;
+            }
+            previous = std::move(current);
+            have_previous = reconstructed;
+        }
+    }
+    return false;
+}
+
+} // end namespace tcb
+
+#undef TCB_CONSTEXPR14
+
+#endif // TCB_MODULAR_HPP_INCLUDED
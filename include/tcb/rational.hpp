@@ -7,6 +7,7 @@
 #define TCB_RATIONAL_HPP_INCLUDED
 
 #include <cstdint>
+#include <limits>
 #include <ratio>
 #include <type_traits>
 
@@ -24,22 +25,254 @@
 #define TCB_CONSTEXPR14
 #endif
 
-#if __cpp_concepts >= 201500
+// The Concepts TS syntax used below is not valid C++20
+#if __cpp_concepts >= 201500 && __cpp_concepts < 201907
 #define TCB_HAVE_CONCEPTS
 #endif
 
+#if __cpp_nontype_template_args >= 201911
+#define TCB_RATIONAL_STRUCTURAL
+#endif
+
+#ifdef __SIZEOF_INT128__
+#define TCB_RATIONAL_HAVE_INT128
+#endif
+
+#ifdef __has_builtin
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define TCB_RATIONAL_HAVE_IS_CONSTANT_EVALUATED
+#endif
+#endif
+
+// Defining TCB_RATIONAL_DEBUG checks with assert() that values given to the
+// normalized constructor are in lowest terms with a positive denominator
+#ifdef TCB_RATIONAL_DEBUG
+#include <cassert>
+#endif
+
+// TCB_RATIONAL_GCD_HOOK(a, b) may be defined before including this header
+// to observe each GCD computed at run time, for example to count them in a
+// benchmark. It is not invoked during constant evaluation.
+#if defined(TCB_RATIONAL_GCD_HOOK) && !defined(TCB_RATIONAL_HAVE_IS_CONSTANT_EVALUATED)
+#error "TCB_RATIONAL_GCD_HOOK requires __builtin_is_constant_evaluated()"
+#endif
+
+// Defining TCB_RATIONAL_INSTRUMENT enables the per-thread counters returned
+// by tcb::rational_counters_snapshot(). Otherwise, they compile to nothing.
+// It must be defined the same way in every translation unit of a program.
+#ifdef TCB_RATIONAL_INSTRUMENT
+#ifndef TCB_RATIONAL_HAVE_IS_CONSTANT_EVALUATED
+#error "TCB_RATIONAL_INSTRUMENT requires __builtin_is_constant_evaluated()"
+#endif
+#define TCB_RATIONAL_COUNT(call) TCB_RATIONAL_AT_RUN_TIME(::tcb::detail::call)
+#else
+#define TCB_RATIONAL_COUNT(call)
+#endif
+
+// Defining TCB_RATIONAL_USDT adds USDT probes (for bpftrace, perf or
+// SystemTap) to the hot paths, under the provider tcb_rational:
+//
+//   gcd_entry(a, b)
+//   gcd_exit(result, iterations)
+//   normalize(num, denom, reduced_num, reduced_denom)
+//   near_overflow(num, denom)
+//
+// near_overflow fires from simplify() when the unreduced numerator or
+// denominator is within TCB_RATIONAL_NEAR_OVERFLOW_BITS of its type's range.
+// Arguments wider than 64 bits are truncated. Each probe is a single nop
+// until a tracer attaches.
+#ifdef TCB_RATIONAL_USDT
+#ifndef TCB_RATIONAL_HAVE_IS_CONSTANT_EVALUATED
+#error "TCB_RATIONAL_USDT requires __builtin_is_constant_evaluated()"
+#endif
+#include <sys/sdt.h>
+#define TCB_RATIONAL_PROBE(call) TCB_RATIONAL_AT_RUN_TIME(::tcb::detail::call)
+#else
+#define TCB_RATIONAL_PROBE(call)
+#endif
+
+#ifndef TCB_RATIONAL_NEAR_OVERFLOW_BITS
+#define TCB_RATIONAL_NEAR_OVERFLOW_BITS 1
+#endif
+
+#if defined(TCB_RATIONAL_INSTRUMENT) || defined(TCB_RATIONAL_USDT)
+#define TCB_RATIONAL_COUNT_GCD_ITERATIONS
+#endif
+
+// Runs stmt, unless in a constant expression
+#define TCB_RATIONAL_AT_RUN_TIME(stmt) \
+    do { \
+        if (!__builtin_is_constant_evaluated()) { \
+            stmt; \
+        } \
+    } while (false)
+
+// Defining TCB_RATIONAL_PROFILE samples operand sizes; see rational_profile.hpp
+#ifdef TCB_RATIONAL_PROFILE
+#ifndef TCB_RATIONAL_HAVE_IS_CONSTANT_EVALUATED
+#error "TCB_RATIONAL_PROFILE requires __builtin_is_constant_evaluated()"
+#endif
+#include <tcb/rational_profile.hpp>
+#define TCB_RATIONAL_SAMPLE(num, denom) \
+    TCB_RATIONAL_AT_RUN_TIME(::tcb::detail::profile_sample(num, denom))
+#else
+#define TCB_RATIONAL_SAMPLE(num, denom)
+#endif
+
 namespace tcb {
 
+#ifdef TCB_RATIONAL_INSTRUMENT
+
+enum class rational_operation {
+    add, subtract, multiply, divide, equality, ordering
+};
+
+// Counts of the work done by rational arithmetic on the calling thread
+struct rational_counters {
+    static constexpr int num_operations = 6;
+
+    std::uint64_t simplify_calls = 0;
+    std::uint64_t gcd_calls = 0;
+    std::uint64_t gcd_iterations = 0;
+    std::uint64_t operations[num_operations] = {};
+
+    // Results of simplify() whose unreduced numerator or denominator came
+    // within TCB_RATIONAL_NEAR_OVERFLOW_BITS bits of overflowing, and the
+    // fewest spare bits seen
+    std::uint64_t near_overflows = 0;
+    int min_headroom_bits = std::numeric_limits<int>::max();
+
+    std::uint64_t operator[](rational_operation op) const
+    {
+        return operations[static_cast<int>(op)];
+    }
+};
+
+namespace detail {
+
+inline rational_counters& thread_counters()
+{
+    thread_local rational_counters counters;
+    return counters;
+}
+
+inline void count_gcd(std::uint64_t iterations)
+{
+    auto& counters = thread_counters();
+    ++counters.gcd_calls;
+    counters.gcd_iterations += iterations;
+}
+
+inline void count_operation(rational_operation op)
+{
+    ++thread_counters().operations[static_cast<int>(op)];
+}
+
+template <typename T>
+void count_simplify(T num, T denom)
+{
+    using unsigned_type = std::make_unsigned_t<T>;
+    const auto mag = [](T val) {
+        return val < 0 ? static_cast<unsigned_type>(0u - static_cast<unsigned_type>(val))
+                       : static_cast<unsigned_type>(val);
+    };
+    unsigned_type largest = mag(num) > mag(denom) ? mag(num) : mag(denom);
+    int headroom = std::numeric_limits<T>::digits;
+    for (; largest != 0; largest >>= 1) {
+        --headroom;
+    }
+
+    auto& counters = thread_counters();
+    ++counters.simplify_calls;
+    if (headroom <= TCB_RATIONAL_NEAR_OVERFLOW_BITS) {
+        ++counters.near_overflows;
+    }
+    if (headroom < counters.min_headroom_bits) {
+        counters.min_headroom_bits = headroom;
+    }
+}
+
+} // end namespace detail
+
+// Returns a copy of the calling thread's counters
+inline rational_counters rational_counters_snapshot()
+{
+    return detail::thread_counters();
+}
+
+inline void reset_rational_counters()
+{
+    detail::thread_counters() = rational_counters{};
+}
+
+#endif // TCB_RATIONAL_INSTRUMENT
+
+#ifdef TCB_RATIONAL_USDT
+
+namespace detail {
+
+// The probes are kept out of line from the constexpr functions, which may
+// not contain inline assembly before C++20
+
+inline void probe_gcd_entry(long long a, long long b)
+{
+    DTRACE_PROBE2(tcb_rational, gcd_entry, a, b);
+}
+
+inline void probe_gcd_exit(long long result, unsigned long long iterations)
+{
+    DTRACE_PROBE2(tcb_rational, gcd_exit, result, iterations);
+}
+
+inline void probe_normalize(long long num, long long denom,
+                            long long reduced_num, long long reduced_denom)
+{
+    DTRACE_PROBE4(tcb_rational, normalize, num, denom, reduced_num, reduced_denom);
+}
+
+template <typename T>
+void probe_near_overflow(T num, T denom)
+{
+    using unsigned_type = std::make_unsigned_t<T>;
+    const auto mag = [](T val) {
+        return val < 0 ? static_cast<unsigned_type>(0u - static_cast<unsigned_type>(val))
+                       : static_cast<unsigned_type>(val);
+    };
+    constexpr auto limit = static_cast<unsigned_type>(
+            static_cast<unsigned_type>(std::numeric_limits<T>::max()) >>
+            TCB_RATIONAL_NEAR_OVERFLOW_BITS);
+    if (mag(num) > limit || mag(denom) > limit) {
+        DTRACE_PROBE2(tcb_rational, near_overflow, static_cast<long long>(num),
+                      static_cast<long long>(denom));
+    }
+}
+
+} // end namespace detail
+
+#endif // TCB_RATIONAL_USDT
+
 namespace detail {
 
 template <typename T>
 TCB_CONSTEXPR14 T gcd(T a, T b)
 {
+#ifdef TCB_RATIONAL_GCD_HOOK
+    TCB_RATIONAL_AT_RUN_TIME(TCB_RATIONAL_GCD_HOOK(a, b));
+#endif
+    TCB_RATIONAL_PROBE(probe_gcd_entry(static_cast<long long>(a), static_cast<long long>(b)));
+#ifdef TCB_RATIONAL_COUNT_GCD_ITERATIONS
+    std::uint64_t iterations = 0;
+#endif
     while (b != 0) {
         T t = b;
         b = a % b;
         a = t;
+#ifdef TCB_RATIONAL_COUNT_GCD_ITERATIONS
+        ++iterations;
+#endif
     }
+    TCB_RATIONAL_COUNT(count_gcd(iterations));
+    TCB_RATIONAL_PROBE(probe_gcd_exit(static_cast<long long>(a), iterations));
     return a;
 }
 
@@ -56,6 +289,83 @@ constexpr T abs(T val)
     return val < 0 ? -val : val;
 }
 
+/*
+ * The arithmetic operations on reduced operands n1/d1 and n2/d2, storing
+ * the result in num and denom and returning whether it still needs to be
+ * reduced. Operands which are integers or share a denominator, which are
+ * common in practice, take shorter paths; the tests are cheap and, for
+ * data of one kind, predictable.
+ */
+
+template <bool Subtract, typename T>
+TCB_CONSTEXPR14 bool add_reduced(T n1, T d1, T n2, T d2, T& num, T& denom)
+{
+    if (Subtract) {
+        n2 = static_cast<T>(-n2);
+    }
+    if (d1 == d2) {
+        // Only gcd(n1 + n2, d) can be taken out, and none if d == 1
+        num = static_cast<T>(n1 + n2);
+        denom = d1;
+        return d1 != 1;
+    }
+    if (d2 == 1) {
+        // gcd(n1 + n2*d1, d1) == gcd(n1, d1) == 1
+        num = static_cast<T>(n1 + n2 * d1);
+        denom = d1;
+        return false;
+    }
+    if (d1 == 1) {
+        num = static_cast<T>(n1 * d2 + n2);
+        denom = d2;
+        return false;
+    }
+    num = static_cast<T>(n1 * d2 + n2 * d1);
+    denom = static_cast<T>(d1 * d2);
+    return true;
+}
+
+template <typename T>
+TCB_CONSTEXPR14 bool multiply_reduced(T n1, T d1, T n2, T d2, T& num, T& denom)
+{
+    if (d1 == 1 && d2 == 1) {
+        num = static_cast<T>(n1 * n2);
+        denom = 1;
+        return false;
+    }
+    // An integer factor can only cancel with the other's denominator
+    if (d2 == 1) {
+        const T g = abs(gcd(n2, d1));
+        num = static_cast<T>(n1 * (n2 / g));
+        denom = static_cast<T>(d1 / g);
+        return false;
+    }
+    if (d1 == 1) {
+        const T g = abs(gcd(n1, d2));
+        num = static_cast<T>((n1 / g) * n2);
+        denom = static_cast<T>(d2 / g);
+        return false;
+    }
+    num = static_cast<T>(n1 * n2);
+    denom = static_cast<T>(d1 * d2);
+    return true;
+}
+
+// Precondition: n2 != 0
+template <typename T>
+TCB_CONSTEXPR14 bool divide_reduced(T n1, T d1, T n2, T d2, T& num, T& denom)
+{
+    if (d1 == d2) {
+        // (n1/d) / (n2/d) == n1/n2, which needs its sign fixed and reducing
+        num = n1;
+        denom = n2;
+        return true;
+    }
+    num = static_cast<T>(n1 * d2);
+    denom = static_cast<T>(d1 * n2);
+    return true;
+}
+
 
 template<typename...>
 using void_t = void;
@@ -72,6 +382,201 @@ constexpr bool is_nonnarrowing_assignable_v = is_nonnarrowing_assignable<T, U>::
 
 } // end namespace detail
 
+/*
+ * Rounding modes for operations which produce an integer from a rational
+ * quantity. nearest rounds halfway cases away from zero.
+ */
+
+enum class rounding {
+    toward_zero,
+    away_from_zero,
+    down,
+    up,
+    nearest
+};
+
+namespace detail {
+
+/*
+ * Double-width unsigned arithmetic on 32- and 64-bit words, used by the
+ * companion headers to form exact products before dividing
+ */
+
+#ifdef TCB_RATIONAL_HAVE_INT128
+__extension__ typedef __int128 int128_t;
+__extension__ typedef unsigned __int128 uint128_t;
+#endif
+
+template <typename W>
+struct double_word {
+    W hi;
+    W lo;
+};
+
+template <typename W>
+using word_digits = std::integral_constant<int, std::numeric_limits<W>::digits>;
+
+// The full product of two words
+inline TCB_CONSTEXPR14 double_word<std::uint32_t>
+mul_wide(std::uint32_t a, std::uint32_t b)
+{
+    const std::uint64_t p = static_cast<std::uint64_t>(a) * b;
+    return {static_cast<std::uint32_t>(p >> 32), static_cast<std::uint32_t>(p)};
+}
+
+inline TCB_CONSTEXPR14 double_word<std::uint64_t>
+mul_wide(std::uint64_t a, std::uint64_t b)
+{
+#ifdef TCB_RATIONAL_HAVE_INT128
+    const uint128_t p = static_cast<uint128_t>(a) * b;
+    return {static_cast<std::uint64_t>(p >> 64), static_cast<std::uint64_t>(p)};
+#else
+    const std::uint64_t a_lo = a & 0xFFFFFFFF, a_hi = a >> 32;
+    const std::uint64_t b_lo = b & 0xFFFFFFFF, b_hi = b >> 32;
+    const std::uint64_t p00 = a_lo * b_lo;
+    const std::uint64_t p01 = a_lo * b_hi;
+    const std::uint64_t p10 = a_hi * b_lo;
+    const std::uint64_t mid = (p00 >> 32) + (p01 & 0xFFFFFFFF) + (p10 & 0xFFFFFFFF);
+    return {a_hi * b_hi + (p01 >> 32) + (p10 >> 32) + (mid >> 32),
+            (mid << 32) | (p00 & 0xFFFFFFFF)};
+#endif
+}
+
+template <typename W>
+TCB_CONSTEXPR14 int count_leading_zeros(W w)
+{
+    int n = 0;
+    for (W bit = W{1} << (word_digits<W>::value - 1); bit != 0 && !(w & bit); bit >>= 1) {
+        ++n;
+    }
+    return n;
+}
+
+// Divides the double word (hi, lo) by d one bit at a time. Requires hi < d,
+// so that the quotient fits in a single word.
+template <typename W>
+TCB_CONSTEXPR14 W div_wide_slow(W hi, W lo, W d, W& rem)
+{
+    constexpr int digits = word_digits<W>::value;
+    W q = 0;
+    for (int i = digits - 1; i >= 0; --i) {
+        const bool carry = (hi >> (digits - 1)) != 0;
+        hi = static_cast<W>((hi << 1) | ((lo >> i) & 1));
+        q = static_cast<W>(q << 1);
+        if (carry || hi >= d) {
+            hi -= d;
+            q |= 1;
+        }
+    }
+    rem = hi;
+    return q;
+}
+
+// As above, using hardware division where it is available
+inline TCB_CONSTEXPR14 std::uint32_t
+div_wide(std::uint32_t hi, std::uint32_t lo, std::uint32_t d, std::uint32_t& rem)
+{
+    const std::uint64_t n = (static_cast<std::uint64_t>(hi) << 32) | lo;
+    rem = static_cast<std::uint32_t>(n % d);
+    return static_cast<std::uint32_t>(n / d);
+}
+
+inline TCB_CONSTEXPR14 std::uint64_t
+div_wide(std::uint64_t hi, std::uint64_t lo, std::uint64_t d, std::uint64_t& rem)
+{
+#ifdef TCB_RATIONAL_HAVE_INT128
+    const uint128_t n = (static_cast<uint128_t>(hi) << 64) | lo;
+    rem = static_cast<std::uint64_t>(n % d);
+    return static_cast<std::uint64_t>(n / d);
+#else
+    return div_wide_slow(hi, lo, d, rem);
+#endif
+}
+
+// Division of double words by a fixed single-word divisor, using a
+// precomputed reciprocal in place of a hardware divide. See Moller and
+// Granlund, "Improved division by invariant integers" (2011).
+template <typename W>
+class invariant_divider {
+public:
+    TCB_CONSTEXPR14 explicit invariant_divider(W d)
+        : divisor_(d),
+          shift_(count_leading_zeros(d)),
+          norm_(static_cast<W>(d << shift_)),
+          recip_(reciprocal(norm_))
+    {}
+
+    constexpr W divisor() const { return divisor_; }
+
+    // Requires hi < divisor()
+    TCB_CONSTEXPR14 W divide(W hi, W lo, W& rem) const
+    {
+        constexpr int digits = word_digits<W>::value;
+        // Normalise the dividend along with the divisor. Shifting lo right
+        // in two steps avoids an undefined shift by the full width.
+        hi = static_cast<W>((hi << shift_) | ((lo >> 1) >> (digits - 1 - shift_)));
+        lo = static_cast<W>(lo << shift_);
+
+        const double_word<W> p = mul_wide(recip_, hi);
+        const W q0 = static_cast<W>(p.lo + lo);
+        W q1 = static_cast<W>(p.hi + hi + (q0 < lo) + 1);
+        W r = static_cast<W>(lo - q1 * norm_);
+        if (r > q0) {
+            --q1;
+            r += norm_;
+        }
+        if (r >= norm_) {
+            ++q1;
+            r -= norm_;
+        }
+        rem = static_cast<W>(r >> shift_);
+        return q1;
+    }
+
+private:
+    // floor((2^2N - 1) / d) - 2^N, for normalised d
+    static TCB_CONSTEXPR14 W reciprocal(W d)
+    {
+        W rem = 0;
+        return div_wide_slow(static_cast<W>(~d), static_cast<W>(~W{0}), d, rem);
+    }
+
+    W divisor_;
+    int shift_;
+    W norm_;
+    W recip_;
+};
+
+// Adjusts the truncated quotient q = n/d with remainder r, of magnitudes,
+// according to the rounding mode
+template <typename W>
+constexpr W round_quotient(W q, W r, W d, bool negative, rounding mode)
+{
+    return q + ((mode == rounding::toward_zero) ? 0 :
+                (mode == rounding::away_from_zero) ? (r != 0) :
+                (mode == rounding::down) ? (r != 0 && negative) :
+                (mode == rounding::up) ? (r != 0 && !negative) :
+                /* rounding::nearest */ (r >= d - r));
+}
+
+#ifdef TCB_RATIONAL_DEBUG
+template <typename T>
+TCB_CONSTEXPR14 bool is_normalized(T num, T denom)
+{
+    return denom > 0 && abs(gcd(num, denom)) == 1;
+}
+#endif
+
+} // end namespace detail
+
+// Selects the constructor which trusts that its arguments are already in
+// lowest terms with a positive denominator, skipping the GCD
+struct normalized_t {
+    explicit normalized_t() = default;
+};
+
+constexpr normalized_t normalized{};
+
 template <typename T>
 class rational {
 public:
@@ -95,6 +600,19 @@ public:
         simplify();
     }
 
+    // Precondition: gcd(num, denom) == 1 and denom > 0
+#ifdef TCB_RATIONAL_DEBUG
+    TCB_CONSTEXPR14 rational(normalized_t, value_type num, value_type denom)
+        : num_{num}, denom_{denom}
+    {
+        assert(detail::is_normalized(num, denom));
+    }
+#else
+    constexpr rational(normalized_t, value_type num, value_type denom)
+        : num_{num}, denom_{denom}
+    {}
+#endif
+
     constexpr rational(const rational&) = default;
 
     template <typename U,
@@ -134,10 +652,9 @@ public:
     template <typename U>
     TCB_CONSTEXPR14 rational& operator+=(const rational<U>& other)
     {
-        num_ *= other.denom();
-        num_ += denom_ * other.num();
-        denom_ *= other.denom();
-        simplify();
+        TCB_RATIONAL_COUNT(count_operation(rational_operation::add));
+        finish(detail::add_reduced<false>(num_, denom_, static_cast<T>(other.num()),
+                                          static_cast<T>(other.denom()), num_, denom_));
         return *this;
     }
 
@@ -151,10 +668,9 @@ public:
     template <typename U>
     TCB_CONSTEXPR14 rational& operator-=(const rational<U>& other)
     {
-        num_ *= other.denom();
-        num_ -= denom_ * other.num();
-        denom_ *= other.denom();
-        simplify();
+        TCB_RATIONAL_COUNT(count_operation(rational_operation::subtract));
+        finish(detail::add_reduced<true>(num_, denom_, static_cast<T>(other.num()),
+                                         static_cast<T>(other.denom()), num_, denom_));
         return *this;
     }
 
@@ -167,9 +683,9 @@ public:
     template <typename U>
     TCB_CONSTEXPR14 rational& operator*=(const rational<U>& other)
     {
-        num_ *= other.num();
-        denom_ *= other.denom();
-        simplify();
+        TCB_RATIONAL_COUNT(count_operation(rational_operation::multiply));
+        finish(detail::multiply_reduced(num_, denom_, static_cast<T>(other.num()),
+                                        static_cast<T>(other.denom()), num_, denom_));
         return *this;
     }
 
@@ -182,9 +698,9 @@ public:
     template <typename U>
     TCB_CONSTEXPR14 rational& operator/=(const rational<U>& other)
     {
-        num_ *= other.denom();
-        denom_ *= other.num();
-        simplify();
+        TCB_RATIONAL_COUNT(count_operation(rational_operation::divide));
+        finish(detail::divide_reduced(num_, denom_, static_cast<T>(other.num()),
+                                      static_cast<T>(other.denom()), num_, denom_));
         return *this;
     }
 
@@ -199,7 +715,7 @@ public:
     template <typename U>
     constexpr explicit operator rational<U>() const
     {
-        return rational<U>{static_cast<U>(num_), static_cast<U>(denom_)};
+        return rational<U>{normalized, static_cast<U>(num_), static_cast<U>(denom_)};
     }
 
     constexpr operator long double() const
@@ -207,16 +723,45 @@ public:
         return num_/static_cast<long double>(denom_);
     }
 
+#ifdef TCB_RATIONAL_STRUCTURAL
+public:
+    // In C++20 the data members are public so that rational is a structural
+    // type, usable as a non-type template parameter. They are not part of
+    // the interface: use num() and denom().
+#else
 private:
+#endif
     value_type num_ = 0;
     value_type denom_ = 1;
 
+private:
     TCB_CONSTEXPR14 void simplify()
     {
         using namespace detail;
+        TCB_RATIONAL_COUNT(count_simplify(num_, denom_));
+        TCB_RATIONAL_PROBE(probe_near_overflow(num_, denom_));
+#ifdef TCB_RATIONAL_USDT
+        const value_type unreduced_num = num_;
+        const value_type unreduced_denom = denom_;
+#endif
         auto g = abs(gcd(num_, denom_));
         num_ = sign(denom_) * num_/g;
         denom_ = abs(denom_)/g;
+        TCB_RATIONAL_PROBE(probe_normalize(static_cast<long long>(unreduced_num),
+                                           static_cast<long long>(unreduced_denom),
+                                           static_cast<long long>(num_),
+                                           static_cast<long long>(denom_)));
+        TCB_RATIONAL_SAMPLE(num_, denom_);
+    }
+
+    // Completes an arithmetic operation, whose result may already be reduced
+    TCB_CONSTEXPR14 void finish(bool reduce)
+    {
+        if (reduce) {
+            simplify();
+        } else {
+            TCB_RATIONAL_SAMPLE(num_, denom_);
+        }
     }
 
 };
@@ -241,6 +786,28 @@ using rational32_t = rational<std::int_least32_t>;
 using rational64_t = rational<std::int_least64_t>;
 using rational_max_t = rational<std::intmax_t>;
 
+/*
+ * A rational constant whose value is part of its type. Like std::ratio, the
+ * value is reduced at compile time; unlike std::ratio, arithmetic between a
+ * static_rational and a rational<T> is performed at the width of T.
+ */
+
+template <std::intmax_t Num, std::intmax_t Denom = 1>
+struct static_rational {
+    using ratio_type = typename std::ratio<Num, Denom>::type;
+
+    static constexpr std::intmax_t num() { return ratio_type::num; }
+
+    static constexpr std::intmax_t denom() { return ratio_type::den; }
+
+    template <typename T>
+    constexpr explicit operator rational<T>() const
+    {
+        return rational<T>{normalized, static_cast<T>(num()),
+                           static_cast<T>(denom())};
+    }
+};
+
 /*
  * SFINAE-able type trait for rational types
  */
@@ -256,6 +823,9 @@ struct is_rational<rational<T>>
 template <std::intmax_t Num, std::intmax_t Denom>
 struct is_rational<std::ratio<Num, Denom>> : std::true_type {};
 
+template <std::intmax_t Num, std::intmax_t Denom>
+struct is_rational<static_rational<Num, Denom>> : std::true_type {};
+
 template <typename T>
 constexpr bool is_rational_v = is_rational<T>::value;
 
@@ -279,11 +849,224 @@ struct rational_value_type<std::ratio<Num, Denom>> {
     using type = std::intmax_t;
 };
 
+template <std::intmax_t Num, std::intmax_t Denom>
+struct rational_value_type<static_rational<Num, Denom>> {
+    using type = std::intmax_t;
+};
+
+// Compile-time rational constants, and their values as a reduced std::ratio
+template <typename T>
+struct is_static_rational : std::false_type {};
+
+template <std::intmax_t Num, std::intmax_t Denom>
+struct is_static_rational<std::ratio<Num, Denom>> : std::true_type {
+    using ratio_type = typename std::ratio<Num, Denom>::type;
+};
+
+template <std::intmax_t Num, std::intmax_t Denom>
+struct is_static_rational<static_rational<Num, Denom>> : std::true_type {
+    using ratio_type = typename static_rational<Num, Denom>::ratio_type;
+};
+
+template <typename T>
+using static_ratio_t = typename is_static_rational<T>::ratio_type;
+
+template <typename T>
+struct is_static_rational_class : std::false_type {};
+
+template <std::intmax_t Num, std::intmax_t Denom>
+struct is_static_rational_class<static_rational<Num, Denom>> : std::true_type {};
+
+template <typename T>
+struct is_rational_class : std::false_type {};
+
+template <typename T>
+struct is_rational_class<rational<T>> : std::true_type {};
+
+// A rational<T> and a compile-time constant, in either order
+template <typename T, typename U>
+constexpr bool is_static_mix_v =
+        (is_rational_class<T>::value && is_static_rational<U>::value) ||
+        (is_static_rational<T>::value && is_rational_class<U>::value);
+
+// Two compile-time constants, at least one of which is a static_rational
+template <typename T, typename U>
+constexpr bool is_static_pair_v =
+        is_static_rational<T>::value && is_static_rational<U>::value &&
+        (is_static_rational_class<T>::value || is_static_rational_class<U>::value);
+
+// Whether the general-purpose binary operators handle these operands
+template <typename T, typename U>
+constexpr bool use_generic_arithmetic_v =
+        is_rational_v<T> && is_rational_v<U> &&
+        !is_static_mix_v<T, U> && !is_static_pair_v<T, U>;
+
 } // end namespace detail
 
 template <typename T>
 using rational_value_t = typename detail::rational_value_type<T>::type;
 
+/*
+ * Result type policies for the binary arithmetic operators
+ *
+ * A policy provides two member alias templates, each taking the two operand
+ * types: value_type is the value type of the resulting rational, and
+ * compute_type is the type in which the intermediate products are formed and
+ * reduced before being converted to value_type.
+ */
+
+namespace detail {
+
+template <std::size_t Size, bool Signed>
+struct sized_integer {};
+
+template <> struct sized_integer<1, true> { using type = std::int_least8_t; };
+template <> struct sized_integer<1, false> { using type = std::uint_least8_t; };
+template <> struct sized_integer<2, true> { using type = std::int_least16_t; };
+template <> struct sized_integer<2, false> { using type = std::uint_least16_t; };
+template <> struct sized_integer<4, true> { using type = std::int_least32_t; };
+template <> struct sized_integer<4, false> { using type = std::uint_least32_t; };
+template <> struct sized_integer<8, true> { using type = std::int_least64_t; };
+template <> struct sized_integer<8, false> { using type = std::uint_least64_t; };
+
+// The integer type of twice the width of T, saturating at std::intmax_t
+template <typename T>
+using next_wider_t = typename sized_integer<
+        (sizeof(T) < sizeof(std::intmax_t) ? 2 * sizeof(T) : sizeof(std::intmax_t)),
+        std::is_signed<T>::value>::type;
+
+// The integer type of twice the width of T, as next_wider_t but going on to
+// 128 bits for 64-bit T where the compiler has 128-bit integers and the
+// standard library counts them as integral (as in GNU mode). Elsewhere it
+// too stops at std::intmax_t.
+#ifdef TCB_RATIONAL_HAVE_INT128
+template <typename T>
+using double_width_t = std::conditional_t<
+        (sizeof(T) < sizeof(std::int64_t)) || !std::is_integral<int128_t>::value,
+        next_wider_t<T>, std::conditional_t<std::is_signed<T>::value, int128_t, uint128_t>>;
+#else
+template <typename T>
+using double_width_t = next_wider_t<T>;
+#endif
+
+// Whether products of two Ts are exact in double_width_t<T>
+template <typename T>
+constexpr bool has_double_width_v = sizeof(double_width_t<T>) > sizeof(T);
+
+// The larger of two integer types, preferring the unsigned type if they are
+// the same size (as the usual arithmetic conversions would)
+template <typename T, typename U>
+using wider_of_t = std::conditional_t<(sizeof(T) > sizeof(U)), T,
+                   std::conditional_t<(sizeof(U) > sizeof(T)), U,
+                   std::conditional_t<std::is_unsigned<U>::value, U, T>>>;
+
+// A compile-time constant takes on the value type of a rational<T> operand
+template <typename T, typename U>
+struct adapted_value { using type = rational_value_t<T>; };
+
+template <std::intmax_t Num, std::intmax_t Denom, typename U>
+struct adapted_value<std::ratio<Num, Denom>, rational<U>> { using type = U; };
+
+template <std::intmax_t Num, std::intmax_t Denom, typename U>
+struct adapted_value<static_rational<Num, Denom>, rational<U>> { using type = U; };
+
+template <typename T, typename U>
+using promoted_value_t = decltype(std::declval<typename adapted_value<T, U>::type>() +
+                                  std::declval<typename adapted_value<U, T>::type>());
+
+// Only rational<T> operands carry a width; plain integers and compile-time
+// constants adapt to the width of the other operand
+struct no_width {};
+
+template <typename T>
+struct carried_width { using type = no_width; };
+
+template <typename T>
+struct carried_width<rational<T>> { using type = T; };
+
+template <typename T, typename U, typename Fallback>
+struct combine_width { using type = wider_of_t<T, U>; };
+
+template <typename T, typename Fallback>
+struct combine_width<T, no_width, Fallback> { using type = T; };
+
+template <typename U, typename Fallback>
+struct combine_width<no_width, U, Fallback> { using type = U; };
+
+template <typename Fallback>
+struct combine_width<no_width, no_width, Fallback> { using type = Fallback; };
+
+template <typename T, typename U>
+using preserved_value_t = typename combine_width<
+        typename carried_width<T>::type, typename carried_width<U>::type,
+        promoted_value_t<T, U>>::type;
+
+} // end namespace detail
+
+// Use the type resulting from the usual arithmetic conversions, so that
+// (for example) rational8_t + rational8_t yields rational<int>
+struct promote_result_policy {
+    template <typename T, typename U>
+    using value_type = detail::promoted_value_t<T, U>;
+
+    template <typename T, typename U>
+    using compute_type = value_type<T, U>;
+};
+
+// Keep the width of the (widest) rational operand, forming the
+// intermediate products in a type twice as wide so that the result is exact
+// whenever the reduced value fits. For 64-bit operands that needs 128-bit
+// integers (see detail::has_double_width_v); without them the products are
+// formed in 64 bits, and may overflow, as with promote_result_policy.
+struct preserve_result_policy {
+    template <typename T, typename U>
+    using value_type = detail::preserved_value_t<T, U>;
+
+    template <typename T, typename U>
+    using compute_type = detail::double_width_t<value_type<T, U>>;
+};
+
+// Widen the (widest) rational operand to the next size up, so that
+// products of the operands are exact. The result stops at std::intmax_t,
+// beyond which this behaves as preserve_result_policy.
+struct widen_result_policy {
+    template <typename T, typename U>
+    using value_type = detail::next_wider_t<detail::preserved_value_t<T, U>>;
+
+    template <typename T, typename U>
+    using compute_type = detail::double_width_t<detail::preserved_value_t<T, U>>;
+};
+
+#ifndef TCB_RATIONAL_RESULT_POLICY
+#define TCB_RATIONAL_RESULT_POLICY ::tcb::promote_result_policy
+#endif
+
+// Customisation point: specialise this to select a policy for particular
+// operand types. The default may be changed by defining
+// TCB_RATIONAL_RESULT_POLICY before including this header.
+template <typename T, typename U>
+struct rational_result_policy {
+    using type = TCB_RATIONAL_RESULT_POLICY;
+};
+
+template <typename T, typename U,
+          typename Policy = typename rational_result_policy<T, U>::type>
+using rational_result_t = rational<typename Policy::template value_type<T, U>>;
+
+namespace detail {
+
+template <typename T, typename U,
+          typename Policy = typename rational_result_policy<T, U>::type>
+using rational_compute_t = typename Policy::template compute_type<T, U>;
+
+template <typename T, typename U>
+constexpr rational<T> narrow_result(const rational<U>& r)
+{
+    return static_cast<rational<T>>(r);
+}
+
+} // end namespace detail
+
 #ifdef TCB_HAVE_CONCEPTS
 
 template <typename T>
@@ -317,6 +1100,12 @@ constexpr std::intmax_t numerator(std::ratio<Num, Denom>)
     return std::ratio<Num, Denom>::num;
 }
 
+template <std::intmax_t Num, std::intmax_t Denom>
+constexpr std::intmax_t numerator(static_rational<Num, Denom> r)
+{
+    return r.num();
+}
+
 template <typename T,
           typename = std::enable_if_t<std::is_integral<T>::value>>
 constexpr T denominator(T)
@@ -336,6 +1125,12 @@ constexpr std::intmax_t denominator(std::ratio<Num, Denom>)
     return std::ratio<Num, Denom>::den;
 }
 
+template <std::intmax_t Num, std::intmax_t Denom>
+constexpr std::intmax_t denominator(static_rational<Num, Denom> r)
+{
+    return r.denom();
+}
+
 
 /*
  * Comparison operators
@@ -346,6 +1141,7 @@ template <typename T, typename U,
           typename = std::enable_if_t<is_rational_v<T> && is_rational_v<U>>>
 constexpr bool operator==(const T& lhs, const U& rhs)
 {
+    TCB_RATIONAL_COUNT(count_operation(rational_operation::equality));
     return numerator(lhs) == numerator(rhs) &&
             denominator(lhs) == denominator(rhs);
 }
@@ -363,6 +1159,7 @@ template <typename T, typename U,
           typename = std::enable_if_t<is_rational_v<T> && is_rational_v<U>>>
 constexpr bool operator<(const T& lhs, const U& rhs)
 {
+    TCB_RATIONAL_COUNT(count_operation(rational_operation::ordering));
     return numerator(lhs) * denominator(rhs) < numerator(rhs) * denominator(lhs);
 }
 
@@ -403,63 +1200,430 @@ constexpr rational<T> operator+(const rational<T>& r)
 template <typename T>
 constexpr rational<T> operator-(const rational<T>& r)
 {
-    return rational<T>{static_cast<T>(-r.num()), r.denom()};
+    return rational<T>{normalized, static_cast<T>(-r.num()), r.denom()};
+}
+
+// Precondition: r != 0
+template <typename T>
+constexpr rational<T> reciprocal(const rational<T>& r)
+{
+    return r.num() < 0
+            ? rational<T>{normalized, static_cast<T>(-r.denom()), static_cast<T>(-r.num())}
+            : rational<T>{normalized, r.denom(), r.num()};
+}
+
+/*
+ * Integer powers
+ *
+ * Powers of coprime integers are coprime, so the numerator and denominator
+ * are raised separately by repeated squaring, and no GCD is needed.
+ */
+
+namespace detail {
+
+template <typename T, typename E>
+TCB_CONSTEXPR14 T int_pow(T base, E exp)
+{
+    T result = 1;
+    while (exp != 0) {
+        if (exp & 1) {
+            result = static_cast<T>(result * base);
+        }
+        exp >>= 1;
+        // Skipping the last squaring means that no intermediate value is
+        // larger than the result
+        if (exp != 0) {
+            base = static_cast<T>(base * base);
+        }
+    }
+    return result;
+}
+
+template <typename M>
+TCB_CONSTEXPR14 int bit_width(M mag)
+{
+    int bits = 0;
+    for (; mag != 0; mag >>= 1) {
+        ++bits;
+    }
+    return bits;
+}
+
+/*
+ * Computes base^exp if it is representable in T. Most cases are decided
+ * from the bit length b of |base| alone, as |base|^exp has between
+ * (b - 1) * exp + 1 and b * exp bits; only the band in between needs its
+ * products checked.
+ */
+template <typename T, typename E>
+TCB_CONSTEXPR14 bool checked_int_pow(T base, E exp, T& result)
+{
+    using magnitude_type = std::make_unsigned_t<T>;
+    const bool negative = base < 0;
+    const magnitude_type mag = static_cast<magnitude_type>(
+            negative ? 0u - static_cast<magnitude_type>(base) : static_cast<magnitude_type>(base));
+    const bool negative_result = negative && (exp & 1);
+    // The most negative value has one more than the largest magnitude
+    const magnitude_type limit = static_cast<magnitude_type>(
+            static_cast<magnitude_type>(std::numeric_limits<T>::max()) + (negative_result ? 1 : 0));
+    if (mag <= 1 || exp == 0) {
+        result = int_pow(base, exp);
+        return true;
+    }
+
+    const int limit_bits = bit_width(limit);
+    // mag^exp >= 2^exp > limit
+    if (exp >= static_cast<E>(limit_bits)) {
+        return false;
+    }
+    const int bits = bit_width(mag);
+    const int n = static_cast<int>(exp);
+    if (bits * n < limit_bits) {
+        result = int_pow(base, exp);
+        return true;
+    }
+    if ((bits - 1) * n + 1 > limit_bits) {
+        return false;
+    }
+
+    magnitude_type power = 1;
+    for (int i = 0; i < n; ++i) {
+        if (power > limit / mag) {
+            return false;
+        }
+        power = static_cast<magnitude_type>(power * mag);
+    }
+    result = static_cast<T>(negative_result ? static_cast<magnitude_type>(0u - power) : power);
+    return true;
+}
+
+template <typename I>
+constexpr std::make_unsigned_t<I> unsigned_abs(I n)
+{
+    return n < 0 ? static_cast<std::make_unsigned_t<I>>(0u - static_cast<std::make_unsigned_t<I>>(n))
+                 : static_cast<std::make_unsigned_t<I>>(n);
+}
+
+} // end namespace detail
+
+// r raised to the power n. Precondition: the result is representable in
+// T, and r != 0 if n < 0.
+template <typename T, typename I,
+          typename = std::enable_if_t<std::is_integral<I>::value>>
+TCB_CONSTEXPR14 rational<T> pow(const rational<T>& r, I n)
+{
+    const rational<T> base = n < 0 ? reciprocal(r) : r;
+    const auto exp = detail::unsigned_abs(n);
+    return {normalized, detail::int_pow(base.num(), exp), detail::int_pow(base.denom(), exp)};
+}
+
+// As pow(), but returns false and leaves result unchanged if r^n is not
+// representable in T (or r == 0 and n < 0)
+template <typename T, typename I,
+          typename = std::enable_if_t<std::is_integral<I>::value>>
+TCB_CONSTEXPR14 bool checked_pow(const rational<T>& r, I n, rational<T>& result)
+{
+    T num = 0;
+    T denom = 1;
+    const auto exp = detail::unsigned_abs(n);
+    if (n < 0) {
+        // The reciprocal's denominator is |r.num()|, with its sign moved to
+        // the numerator
+        if (r.num() == 0 || r.num() == std::numeric_limits<T>::min()) {
+            return false;
+        }
+        const bool negative = r.num() < 0;
+        if (!detail::checked_int_pow(static_cast<T>(negative ? -r.num() : r.num()), exp, denom) ||
+            !detail::checked_int_pow(static_cast<T>(negative ? -r.denom() : r.denom()), exp, num)) {
+            return false;
+        }
+    } else if (!detail::checked_int_pow(r.num(), exp, num) ||
+               !detail::checked_int_pow(r.denom(), exp, denom)) {
+        return false;
+    }
+    result = rational<T>{normalized, num, denom};
+    return true;
 }
 
 /*
  * Binary arithmetic operations
  */
 
+namespace detail {
+
+template <typename T>
+TCB_CONSTEXPR14 rational<T> make_rational(T num, T denom, bool reduce)
+{
+    if (reduce) {
+        return rational<T>(num, denom);
+    }
+    TCB_RATIONAL_SAMPLE(num, denom);
+    return rational<T>(normalized, num, denom);
+}
+
+} // end namespace detail
+
 // Addition
 template <typename T, typename U,
-          typename = std::enable_if_t<is_rational_v<T> && is_rational_v<U>>>
-constexpr auto
+          typename = std::enable_if_t<detail::use_generic_arithmetic_v<T, U>>>
+TCB_CONSTEXPR14 auto
 operator+(const T& lhs, const U& rhs)
 {
-    using value_type = decltype(std::declval<rational_value_t<T>>() +
-                                std::declval<rational_value_t<U>>());
-    return rational<value_type>{
-            denominator(lhs) * numerator(rhs) + denominator(rhs) * numerator(lhs),
-            denominator(lhs) * denominator(rhs)};
+    TCB_RATIONAL_COUNT(count_operation(rational_operation::add));
+    using result_type = rational_result_t<T, U>;
+    using compute_type = detail::rational_compute_t<T, U>;
+    compute_type num = 0;
+    compute_type denom = 1;
+    const bool reduce = detail::add_reduced<false>(
+            static_cast<compute_type>(numerator(lhs)), static_cast<compute_type>(denominator(lhs)),
+            static_cast<compute_type>(numerator(rhs)), static_cast<compute_type>(denominator(rhs)),
+            num, denom);
+    return detail::narrow_result<typename result_type::value_type>(
+            detail::make_rational(num, denom, reduce));
 }
 
 // Subtraction
 template <typename T, typename U,
-        typename = std::enable_if_t<is_rational_v<T> && is_rational_v<U>>>
-constexpr auto
+          typename = std::enable_if_t<detail::use_generic_arithmetic_v<T, U>>>
+TCB_CONSTEXPR14 auto
 operator-(const T& lhs, const U& rhs)
 {
-    using value_type = decltype(std::declval<rational_value_t<T>>() -
-            std::declval<rational_value_t<U>>());
-    return rational<value_type>{
-            numerator(lhs) * denominator(rhs) - numerator(rhs) * denominator(lhs),
-            denominator(lhs) * denominator(rhs)};
+    TCB_RATIONAL_COUNT(count_operation(rational_operation::subtract));
+    using result_type = rational_result_t<T, U>;
+    using compute_type = detail::rational_compute_t<T, U>;
+    compute_type num = 0;
+    compute_type denom = 1;
+    const bool reduce = detail::add_reduced<true>(
+            static_cast<compute_type>(numerator(lhs)), static_cast<compute_type>(denominator(lhs)),
+            static_cast<compute_type>(numerator(rhs)), static_cast<compute_type>(denominator(rhs)),
+            num, denom);
+    return detail::narrow_result<typename result_type::value_type>(
+            detail::make_rational(num, denom, reduce));
 }
 
 // Multiplication
 template <typename T, typename U,
-          typename = std::enable_if_t<is_rational_v<T> && is_rational_v<U>>>
-constexpr auto
+          typename = std::enable_if_t<detail::use_generic_arithmetic_v<T, U>>>
+TCB_CONSTEXPR14 auto
 operator*(const T& lhs, const U& rhs)
 {
-    using value_type = decltype(std::declval<rational_value_t<T>>() *
-            std::declval<rational_value_t<U>>());
-    return rational<value_type>{
-            numerator(lhs) * numerator(rhs),
-            denominator(lhs) * denominator(rhs)};
+    TCB_RATIONAL_COUNT(count_operation(rational_operation::multiply));
+    using result_type = rational_result_t<T, U>;
+    using compute_type = detail::rational_compute_t<T, U>;
+    compute_type num = 0;
+    compute_type denom = 1;
+    const bool reduce = detail::multiply_reduced(
+            static_cast<compute_type>(numerator(lhs)), static_cast<compute_type>(denominator(lhs)),
+            static_cast<compute_type>(numerator(rhs)), static_cast<compute_type>(denominator(rhs)),
+            num, denom);
+    return detail::narrow_result<typename result_type::value_type>(
+            detail::make_rational(num, denom, reduce));
 }
 
 // Division
 template <typename T, typename U,
-        typename = std::enable_if_t<is_rational_v<T> && is_rational_v<U>>>
-constexpr auto
+          typename = std::enable_if_t<detail::use_generic_arithmetic_v<T, U>>>
+TCB_CONSTEXPR14 auto
 operator/(const T& lhs, const U& rhs)
 {
-    using value_type = decltype(std::declval<rational_value_t<T>>() /
-            std::declval<rational_value_t<U>>());
-    return rational<value_type>{
-            numerator(lhs) * denominator(rhs),
-            denominator(lhs) * numerator(rhs)};
+    TCB_RATIONAL_COUNT(count_operation(rational_operation::divide));
+    using result_type = rational_result_t<T, U>;
+    using compute_type = detail::rational_compute_t<T, U>;
+    compute_type num = 0;
+    compute_type denom = 1;
+    const bool reduce = detail::divide_reduced(
+            static_cast<compute_type>(numerator(lhs)), static_cast<compute_type>(denominator(lhs)),
+            static_cast<compute_type>(numerator(rhs)), static_cast<compute_type>(denominator(rhs)),
+            num, denom);
+    return detail::narrow_result<typename result_type::value_type>(
+            detail::make_rational(num, denom, reduce));
+}
+
+/*
+ * Arithmetic with compile-time constants
+ *
+ * The constant has already been reduced, so fewer (and smaller) GCDs are
+ * needed than in the general case, and none at all for integer-valued
+ * constants in addition and subtraction.
+ */
+
+namespace detail {
+
+template <typename T>
+TCB_CONSTEXPR14 T abs_gcd(T a, T b)
+{
+    return abs(gcd(a, b));
+}
+
+// Whether the magnitudes of the constant's terms are representable in T
+template <typename T, std::intmax_t N, std::intmax_t D>
+constexpr bool static_fits_v =
+        static_cast<std::uintmax_t>(N < 0 ? -N : N) <=
+                static_cast<std::uintmax_t>(std::numeric_limits<T>::max()) &&
+        static_cast<std::uintmax_t>(D) <=
+                static_cast<std::uintmax_t>(std::numeric_limits<T>::max());
+
+// (a/b) * (N/D), where a/b is in lowest terms
+template <typename T, std::intmax_t N, std::intmax_t D>
+TCB_CONSTEXPR14 rational<T> multiply_static(T a, T b)
+{
+    static_assert(static_fits_v<T, N, D>,
+                  "Rational constant is not representable in the operand's value type");
+    constexpr T n = static_cast<T>(N);
+    constexpr T d = static_cast<T>(D);
+    if (D == 1) {
+        const T g = abs_gcd(b, n);
+        return {normalized, static_cast<T>(a * (n / g)), static_cast<T>(b / g)};
+    }
+    if (N == 1) {
+        const T g = abs_gcd(a, d);
+        return {normalized, static_cast<T>(a / g), static_cast<T>(b * (d / g))};
+    }
+    const T g1 = abs_gcd(a, d);
+    const T g2 = abs_gcd(b, n);
+    return {normalized, static_cast<T>((a / g1) * (n / g2)),
+            static_cast<T>((b / g2) * (d / g1))};
+}
+
+// (a/b) + (N/D), where a/b is in lowest terms
+template <typename T, std::intmax_t N, std::intmax_t D>
+TCB_CONSTEXPR14 rational<T> add_static(T a, T b)
+{
+    static_assert(static_fits_v<T, N, D>,
+                  "Rational constant is not representable in the operand's value type");
+    constexpr T n = static_cast<T>(N);
+    constexpr T d = static_cast<T>(D);
+    if (D == 1) {
+        // gcd(a + n*b, b) == gcd(a, b) == 1
+        return {normalized, static_cast<T>(a + n * b), b};
+    }
+    const T g = abs_gcd(b, d);
+    if (g == 1) {
+        return {normalized, static_cast<T>(a * d + n * b), static_cast<T>(b * d)};
+    }
+    const T t = static_cast<T>(a * (d / g) + n * (b / g));
+    const T g2 = abs_gcd(t, g);
+    return {normalized, static_cast<T>(t / g2), static_cast<T>((b / g) * (d / g2))};
+}
+
+template <typename T, typename U>
+using static_result_t = typename rational_result_t<T, U>::value_type;
+
+} // end namespace detail
+
+template <typename T, typename S,
+          std::enable_if_t<detail::is_static_rational<S>::value, int> = 0>
+constexpr auto operator+(const rational<T>& lhs, const S&)
+{
+    TCB_RATIONAL_COUNT(count_operation(rational_operation::add));
+    using ratio = detail::static_ratio_t<S>;
+    using compute_type = detail::rational_compute_t<rational<T>, S>;
+    return detail::narrow_result<detail::static_result_t<rational<T>, S>>(
+        detail::add_static<compute_type, ratio::num, ratio::den>(lhs.num(), lhs.denom()));
+}
+
+template <typename S, typename T,
+          std::enable_if_t<detail::is_static_rational<S>::value, int> = 0>
+constexpr auto operator+(const S& lhs, const rational<T>& rhs)
+{
+    return rhs + lhs;
+}
+
+template <typename T, typename S,
+          std::enable_if_t<detail::is_static_rational<S>::value, int> = 0>
+constexpr auto operator-(const rational<T>& lhs, const S&)
+{
+    TCB_RATIONAL_COUNT(count_operation(rational_operation::subtract));
+    using ratio = detail::static_ratio_t<S>;
+    using compute_type = detail::rational_compute_t<rational<T>, S>;
+    return detail::narrow_result<detail::static_result_t<rational<T>, S>>(
+        detail::add_static<compute_type, -ratio::num, ratio::den>(lhs.num(), lhs.denom()));
+}
+
+template <typename S, typename T,
+          std::enable_if_t<detail::is_static_rational<S>::value, int> = 0>
+constexpr auto operator-(const S& lhs, const rational<T>& rhs)
+{
+    return -(rhs - lhs);
+}
+
+template <typename T, typename S,
+          std::enable_if_t<detail::is_static_rational<S>::value, int> = 0>
+constexpr auto operator*(const rational<T>& lhs, const S&)
+{
+    TCB_RATIONAL_COUNT(count_operation(rational_operation::multiply));
+    using ratio = detail::static_ratio_t<S>;
+    using compute_type = detail::rational_compute_t<rational<T>, S>;
+    return detail::narrow_result<detail::static_result_t<rational<T>, S>>(
+        detail::multiply_static<compute_type, ratio::num, ratio::den>(lhs.num(), lhs.denom()));
+}
+
+template <typename S, typename T,
+          std::enable_if_t<detail::is_static_rational<S>::value, int> = 0>
+constexpr auto operator*(const S& lhs, const rational<T>& rhs)
+{
+    return rhs * lhs;
+}
+
+template <typename T, typename S,
+          std::enable_if_t<detail::is_static_rational<S>::value, int> = 0>
+constexpr auto operator/(const rational<T>& lhs, const S&)
+{
+    TCB_RATIONAL_COUNT(count_operation(rational_operation::divide));
+    // The reciprocal of the constant is computed at compile time
+    using ratio = std::ratio<detail::static_ratio_t<S>::den, detail::static_ratio_t<S>::num>;
+    using compute_type = detail::rational_compute_t<rational<T>, S>;
+    return detail::narrow_result<detail::static_result_t<rational<T>, S>>(
+        detail::multiply_static<compute_type, ratio::num, ratio::den>(lhs.num(), lhs.denom()));
+}
+
+template <typename S, typename T,
+          std::enable_if_t<detail::is_static_rational<S>::value, int> = 0>
+constexpr auto operator/(const S&, const rational<T>& rhs)
+{
+    TCB_RATIONAL_COUNT(count_operation(rational_operation::divide));
+    // (N/D) / (a/b) == (b/a) * (N/D), with the sign moved to the numerator
+    using ratio = detail::static_ratio_t<S>;
+    using compute_type = detail::rational_compute_t<S, rational<T>>;
+    return detail::narrow_result<detail::static_result_t<S, rational<T>>>(
+        detail::multiply_static<compute_type, ratio::num, ratio::den>(
+            static_cast<compute_type>(rhs.num() < 0 ? -rhs.denom() : rhs.denom()),
+            static_cast<compute_type>(rhs.num() < 0 ? -rhs.num() : rhs.num())));
+}
+
+// Arithmetic between static_rationals (or a static_rational and a
+// std::ratio) is performed entirely at compile time
+
+template <typename S1, typename S2,
+          std::enable_if_t<detail::is_static_pair_v<S1, S2>, int> = 0>
+constexpr auto operator+(const S1&, const S2&)
+{
+    using ratio = std::ratio_add<detail::static_ratio_t<S1>, detail::static_ratio_t<S2>>;
+    return static_rational<ratio::num, ratio::den>{};
+}
+
+template <typename S1, typename S2,
+          std::enable_if_t<detail::is_static_pair_v<S1, S2>, int> = 0>
+constexpr auto operator-(const S1&, const S2&)
+{
+    using ratio = std::ratio_subtract<detail::static_ratio_t<S1>, detail::static_ratio_t<S2>>;
+    return static_rational<ratio::num, ratio::den>{};
+}
+
+template <typename S1, typename S2,
+          std::enable_if_t<detail::is_static_pair_v<S1, S2>, int> = 0>
+constexpr auto operator*(const S1&, const S2&)
+{
+    using ratio = std::ratio_multiply<detail::static_ratio_t<S1>, detail::static_ratio_t<S2>>;
+    return static_rational<ratio::num, ratio::den>{};
+}
+
+template <typename S1, typename S2,
+          std::enable_if_t<detail::is_static_pair_v<S1, S2>, int> = 0>
+constexpr auto operator/(const S1&, const S2&)
+{
+    using ratio = std::ratio_divide<detail::static_ratio_t<S1>, detail::static_ratio_t<S2>>;
+    return static_rational<ratio::num, ratio::den>{};
 }
 
 /*
@@ -589,5 +1753,10 @@ std::ostream& operator<<(std::ostream& os, const rational<T>& r)
 } // end namespace tcb
 
 #undef TCB_CONSTEXPR14
+#undef TCB_RATIONAL_COUNT
+#undef TCB_RATIONAL_PROBE
+#undef TCB_RATIONAL_SAMPLE
+#undef TCB_RATIONAL_AT_RUN_TIME
+#undef TCB_RATIONAL_COUNT_GCD_ITERATIONS
 
 #endif // TCB_RATIONAL_HPP_INCLUDED
@@ -0,0 +1,349 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_RATIONAL_INTERVAL_HPP_INCLUDED
+#define TCB_RATIONAL_INTERVAL_HPP_INCLUDED
+
+/*
+ * Closed intervals [lower, upper] with rational<T> bounds, for propagating
+ * uncertainty exactly.
+ *
+ * The bounds of a sum, difference, product or quotient are computed
+ * exactly, so the result is the smallest interval containing every value
+ * of the operation. Products classify each operand as non-negative,
+ * non-positive or spanning zero and form only the products which can be
+ * bounds: two in most cases, and all four only when both operands span
+ * zero. Quotients multiply by the reciprocal, which needs no GCD.
+ *
+ * Repeated arithmetic makes the bounds' denominators grow, as it does for
+ * rational<T>. coarsen(i, max_denom) widens an interval to the nearest
+ * bounds with denominators at most max_denom, so that they stay small.
+ *
+ * contains() and width() form their products in a type twice as wide as
+ * T, so unlike ordinary comparisons and subtraction they cannot overflow.
+ * The bounds of arithmetic results must be representable, as for
+ * rational<T>.
+ */
+
+#include <tcb/continued_fraction.hpp>
+#include <tcb/rescale.hpp>
+
+#include <limits>
+#include <type_traits>
+
+#ifdef TCB_HAVE_CONSTEXPR14
+#define TCB_CONSTEXPR14 constexpr
+#else
+#define TCB_CONSTEXPR14
+#endif
+
+namespace tcb {
+
+namespace detail {
+
+// -1, 0 or 1 as a is less than, equal to or greater than b, from full
+// products of the magnitudes
+template <typename T>
+TCB_CONSTEXPR14 int compare_exact(const rational<T>& a, const rational<T>& b)
+{
+    const int sign_a = (a.num() > 0) - (a.num() < 0);
+    const int sign_b = (b.num() > 0) - (b.num() < 0);
+    if (sign_a != sign_b) {
+        return sign_a < sign_b ? -1 : 1;
+    }
+    if (sign_a == 0) {
+        return 0;
+    }
+    using W = unsigned_word_t<T>;
+    const auto lhs = mul_wide(static_cast<W>(magnitude(a.num())), static_cast<W>(b.denom()));
+    const auto rhs = mul_wide(static_cast<W>(magnitude(b.num())), static_cast<W>(a.denom()));
+    const int mag = lhs.hi != rhs.hi ? (lhs.hi < rhs.hi ? -1 : 1)
+                  : lhs.lo != rhs.lo ? (lhs.lo < rhs.lo ? -1 : 1)
+                  : 0;
+    return sign_a > 0 ? mag : -mag;
+}
+
+/*
+ * The neighbours below <= num/denom <= above among the fractions with
+ * denominators at most max_denom >= 1, or num/denom itself for both if its
+ * denominator is small enough. num/denom must be reduced with denom > 0.
+ *
+ * These are the last convergent with denominator at most max_denom and the
+ * largest semiconvergent beyond it, whose components are no larger than
+ * those of num/denom.
+ */
+template <typename I>
+TCB_CONSTEXPR14 void farey_bracket(I num, I denom, I max_denom,
+                                   I& below_num, I& below_denom,
+                                   I& above_num, I& above_denom)
+{
+    if (denom <= max_denom) {
+        below_num = above_num = num;
+        below_denom = above_denom = denom;
+        return;
+    }
+    euclid_state<I> state{num, denom};
+    I p_prev = 1, q_prev = 0;
+    I p = state.next(), q = 1;
+    // Even-numbered convergents lie below num/denom, odd ones above
+    bool even = true;
+    while (true) {
+        const I term = state.next();
+        const I q_next = static_cast<I>(term * q + q_prev);
+        if (q_next > max_denom) {
+            break;
+        }
+        const I p_next = static_cast<I>(term * p + p_prev);
+        p_prev = p;
+        q_prev = q;
+        p = p_next;
+        q = q_next;
+        even = !even;
+    }
+    const I j = static_cast<I>((max_denom - q_prev) / q);
+    const I semi_num = static_cast<I>(p_prev + j * p);
+    const I semi_denom = static_cast<I>(q_prev + j * q);
+    below_num = even ? p : semi_num;
+    below_denom = even ? q : semi_denom;
+    above_num = even ? semi_num : p;
+    above_denom = even ? semi_denom : q;
+}
+
+// A type in which the exact difference of two rational<T>s can be formed
+#ifdef TCB_RATIONAL_HAVE_INT128
+template <typename T>
+using interval_wide_t = std::conditional_t<(sizeof(T) < sizeof(std::int64_t)),
+                                           next_wider_t<T>, int128_t>;
+#else
+template <typename T>
+using interval_wide_t = next_wider_t<T>;
+#endif
+
+// The smallest fraction with components in T which is at least num/denom
+// (reduced and non-negative), saturating at the maximum of T
+template <typename T, typename W>
+TCB_CONSTEXPR14 rational<T> round_up(W num, W denom)
+{
+    const W max = static_cast<W>(std::numeric_limits<T>::max());
+    if (num <= max && denom <= max) {
+        return rational<T>{normalized, static_cast<T>(num), static_cast<T>(denom)};
+    }
+    if (num >= denom) {
+        if (num / denom >= max) {
+            return rational<T>{std::numeric_limits<T>::max()};
+        }
+        // The numerator is the limiting component, so round the reciprocal
+        // down to a denominator of at most max
+        W below_num = 0, below_denom = 1, above_num = 0, above_denom = 1;
+        farey_bracket(denom, num, max, below_num, below_denom, above_num, above_denom);
+        return rational<T>{normalized, static_cast<T>(below_denom), static_cast<T>(below_num)};
+    }
+    W below_num = 0, below_denom = 1, above_num = 0, above_denom = 1;
+    farey_bracket(num, denom, max, below_num, below_denom, above_num, above_denom);
+    return rational<T>{normalized, static_cast<T>(above_num), static_cast<T>(above_denom)};
+}
+
+} // end namespace detail
+
+template <typename T>
+class rational_interval {
+public:
+    // The point interval [0, 0]
+    constexpr rational_interval() = default;
+
+    // The point interval [value, value]
+    constexpr rational_interval(const rational<T>& value)
+        : lower_(value), upper_(value)
+    {}
+
+    // Requires lower <= upper
+    constexpr rational_interval(const rational<T>& lower, const rational<T>& upper)
+        : lower_(lower), upper_(upper)
+    {}
+
+    constexpr const rational<T>& lower() const { return lower_; }
+
+    constexpr const rational<T>& upper() const { return upper_; }
+
+    constexpr bool is_point() const { return lower_ == upper_; }
+
+    TCB_CONSTEXPR14 bool contains(const rational<T>& value) const
+    {
+        return detail::compare_exact(lower_, value) <= 0 &&
+               detail::compare_exact(value, upper_) <= 0;
+    }
+
+    TCB_CONSTEXPR14 bool contains(const rational_interval& other) const
+    {
+        return detail::compare_exact(lower_, other.lower_) <= 0 &&
+               detail::compare_exact(other.upper_, upper_) <= 0;
+    }
+
+    // upper - lower, exactly if it is representable and otherwise rounded up
+    // to the nearest fraction with components in T (or to the maximum of T)
+    TCB_CONSTEXPR14 rational<T> width() const
+    {
+        using W = detail::interval_wide_t<T>;
+        const W num = static_cast<W>(W(upper_.num()) * W(lower_.denom()) -
+                                     W(lower_.num()) * W(upper_.denom()));
+        const W denom = static_cast<W>(W(upper_.denom()) * W(lower_.denom()));
+        const W g = detail::gcd(num, denom);
+        return detail::round_up<T>(static_cast<W>(num / g), static_cast<W>(denom / g));
+    }
+
+    TCB_CONSTEXPR14 rational_interval& operator+=(const rational_interval& other)
+    {
+        lower_ = static_cast<rational<T>>(lower_ + other.lower_);
+        upper_ = static_cast<rational<T>>(upper_ + other.upper_);
+        return *this;
+    }
+
+    TCB_CONSTEXPR14 rational_interval& operator-=(const rational_interval& other)
+    {
+        const rational<T> lower = static_cast<rational<T>>(lower_ - other.upper_);
+        upper_ = static_cast<rational<T>>(upper_ - other.lower_);
+        lower_ = lower;
+        return *this;
+    }
+
+    TCB_CONSTEXPR14 rational_interval& operator*=(const rational_interval& other)
+    {
+        return *this = multiply(*this, other);
+    }
+
+    // Requires that other does not contain zero
+    TCB_CONSTEXPR14 rational_interval& operator/=(const rational_interval& other)
+    {
+        return *this = multiply(*this, rational_interval{reciprocal(other.upper_),
+                                                         reciprocal(other.lower_)});
+    }
+
+    friend constexpr rational_interval operator+(const rational_interval& i)
+    {
+        return i;
+    }
+
+    friend constexpr rational_interval operator-(const rational_interval& i)
+    {
+        return rational_interval{-i.upper_, -i.lower_};
+    }
+
+    friend TCB_CONSTEXPR14 rational_interval operator+(rational_interval lhs,
+                                                       const rational_interval& rhs)
+    {
+        return lhs += rhs;
+    }
+
+    friend TCB_CONSTEXPR14 rational_interval operator-(rational_interval lhs,
+                                                       const rational_interval& rhs)
+    {
+        return lhs -= rhs;
+    }
+
+    friend TCB_CONSTEXPR14 rational_interval operator*(const rational_interval& lhs,
+                                                       const rational_interval& rhs)
+    {
+        return multiply(lhs, rhs);
+    }
+
+    friend TCB_CONSTEXPR14 rational_interval operator/(rational_interval lhs,
+                                                       const rational_interval& rhs)
+    {
+        return lhs /= rhs;
+    }
+
+    friend constexpr bool operator==(const rational_interval& lhs, const rational_interval& rhs)
+    {
+        return lhs.lower_ == rhs.lower_ && lhs.upper_ == rhs.upper_;
+    }
+
+    friend constexpr bool operator!=(const rational_interval& lhs, const rational_interval& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+private:
+    enum class sign_class { non_negative, non_positive, mixed };
+
+    static constexpr sign_class classify(const rational_interval& i)
+    {
+        return i.lower_.num() >= 0 ? sign_class::non_negative
+             : i.upper_.num() <= 0 ? sign_class::non_positive
+             : sign_class::mixed;
+    }
+
+    static TCB_CONSTEXPR14 rational<T> mul(const rational<T>& a, const rational<T>& b)
+    {
+        return static_cast<rational<T>>(a * b);
+    }
+
+    // Only the products of the bounds which can be extreme are formed
+    static TCB_CONSTEXPR14 rational_interval multiply(const rational_interval& a,
+                                                      const rational_interval& b)
+    {
+        const rational<T>& al = a.lower_;
+        const rational<T>& ah = a.upper_;
+        const rational<T>& bl = b.lower_;
+        const rational<T>& bh = b.upper_;
+        switch (classify(a)) {
+        case sign_class::non_negative:
+            switch (classify(b)) {
+            case sign_class::non_negative: return {mul(al, bl), mul(ah, bh)};
+            case sign_class::non_positive: return {mul(ah, bl), mul(al, bh)};
+            case sign_class::mixed: return {mul(ah, bl), mul(ah, bh)};
+            }
+            break;
+        case sign_class::non_positive:
+            switch (classify(b)) {
+            case sign_class::non_negative: return {mul(al, bh), mul(ah, bl)};
+            case sign_class::non_positive: return {mul(ah, bh), mul(al, bl)};
+            case sign_class::mixed: return {mul(al, bh), mul(al, bl)};
+            }
+            break;
+        case sign_class::mixed:
+            switch (classify(b)) {
+            case sign_class::non_negative: return {mul(al, bh), mul(ah, bh)};
+            case sign_class::non_positive: return {mul(ah, bl), mul(al, bl)};
+            case sign_class::mixed: break;
+            }
+            break;
+        }
+        // Both span zero: the lower bound is a negative product and the upper
+        // a positive one
+        const rational<T> l1 = mul(al, bh);
+        const rational<T> l2 = mul(ah, bl);
+        const rational<T> h1 = mul(al, bl);
+        const rational<T> h2 = mul(ah, bh);
+        return {detail::compare_exact(l1, l2) <= 0 ? l1 : l2,
+                detail::compare_exact(h1, h2) >= 0 ? h1 : h2};
+    }
+
+    rational<T> lower_{};
+    rational<T> upper_{};
+};
+
+/*
+ * The smallest interval containing i whose bounds have denominators at
+ * most max_denom, which must be at least 1. Each bound moves outward to its
+ * nearest neighbour in the Farey sequence of order max_denom.
+ */
+template <typename T>
+TCB_CONSTEXPR14 rational_interval<T> coarsen(const rational_interval<T>& i, T max_denom)
+{
+    T lower_num = 0, lower_denom = 1, upper_num = 0, upper_denom = 1;
+    T unused_num = 0, unused_denom = 1;
+    detail::farey_bracket(i.lower().num(), i.lower().denom(), max_denom,
+                          lower_num, lower_denom, unused_num, unused_denom);
+    detail::farey_bracket(i.upper().num(), i.upper().denom(), max_denom,
+                          unused_num, unused_denom, upper_num, upper_denom);
+    return {rational<T>{normalized, lower_num, lower_denom},
+            rational<T>{normalized, upper_num, upper_denom}};
+}
+
+} // end namespace tcb
+
+#undef TCB_CONSTEXPR14
+
+#endif // TCB_RATIONAL_INTERVAL_HPP_INCLUDED
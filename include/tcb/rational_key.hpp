@@ -0,0 +1,306 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_RATIONAL_KEY_HPP_INCLUDED
+#define TCB_RATIONAL_KEY_HPP_INCLUDED
+
+/*
+ * Order-preserving byte keys for rationals.
+ *
+ * encode_key() turns a rational into a string of bytes whose lexicographic
+ * order (as by memcmp(), with a shorter key ordered first if it is a
+ * prefix of a longer one) is the numeric order of the values, so that keys
+ * can be stored in a B-tree or a log-structured store and compared without
+ * decoding them. decode_key() recovers the value.
+ *
+ * A key is a sign byte followed by the continued fraction terms of the
+ * magnitude, [a0; a1, ..., an] in canonical form (an >= 2 if n > 0):
+ *
+ *   0x80                       zero
+ *   0x81 t(a0) ~t(a1) t(a2) ... end    positive
+ *   0x7F and the same, with every byte after the first complemented
+ *                              negative
+ *
+ * A larger term makes the value larger at even positions and smaller at
+ * odd ones, so terms at odd positions are complemented. The end marker
+ * acts as an infinite term, which is what ending the expansion early
+ * amounts to, and is 0xFF at even positions (0x00 at odd ones).
+ *
+ * Each term is coded compactly: a term below 0xF6 is the single byte of
+ * its value, and a larger one is the byte 0xF6 + L followed by its L-byte
+ * big-endian value. Most terms are small, so small and simple values have
+ * short keys: 0 takes one byte, integers up to 245 take three, and 1/2
+ * takes four.
+ *
+ * The bytes depend only on the value, not on T, so keys encoded from
+ * rationals of different widths compare correctly with each other.
+ */
+
+#include <tcb/rescale.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#ifdef TCB_HAVE_CONSTEXPR14
+#define TCB_CONSTEXPR14 constexpr
+#else
+#define TCB_CONSTEXPR14
+#endif
+
+namespace tcb {
+
+namespace detail {
+
+constexpr unsigned char key_negative = 0x7F;
+constexpr unsigned char key_zero = 0x80;
+constexpr unsigned char key_positive = 0x81;
+// Terms below this are a single byte; larger ones are this plus their length
+constexpr unsigned char key_small_terms = 0xF6;
+constexpr unsigned char key_end = 0xFF;
+
+// Writes the coding of term, with every byte xor'd with mask
+template <typename OutputIt>
+TCB_CONSTEXPR14 OutputIt put_key_term(std::uint64_t term, unsigned char mask, OutputIt out)
+{
+    if (term < key_small_terms) {
+        *out++ = static_cast<unsigned char>(term ^ mask);
+        return out;
+    }
+    int length = 1;
+    while (length < 8 && (term >> (8 * length)) != 0) {
+        ++length;
+    }
+    *out++ = static_cast<unsigned char>((key_small_terms + length) ^ mask);
+    for (int i = length - 1; i >= 0; --i) {
+        *out++ = static_cast<unsigned char>(((term >> (8 * i)) & 0xFF) ^ mask);
+    }
+    return out;
+}
+
+// An upper bound on the length of the key of a rational with magnitudes of
+// at most the given number of bits. A continued fraction has at most about
+// 1.44 bits terms, and the extra bytes of the terms which need them are
+// paid for by the size of those terms.
+constexpr std::size_t max_key_size(std::size_t bits)
+{
+    return 7 + 3 * bits / 2 + bits / 4 + bits / 7;
+}
+
+} // end namespace detail
+
+/*
+ * The key of a rational<T>, held inline.
+ */
+template <typename T>
+class rational_key {
+public:
+    // The most bytes the key of any rational<T> needs
+    static constexpr std::size_t capacity =
+            detail::max_key_size(std::numeric_limits<T>::digits + 1);
+
+    constexpr rational_key() = default;
+
+    TCB_CONSTEXPR14 explicit rational_key(const rational<T>& value);
+
+    constexpr const unsigned char* data() const { return bytes_; }
+    constexpr std::size_t size() const { return size_; }
+    constexpr const unsigned char* begin() const { return bytes_; }
+    constexpr const unsigned char* end() const { return bytes_ + size_; }
+
+    // Lexicographic comparison, equivalent to memcmp() followed by
+    // comparing lengths
+    friend TCB_CONSTEXPR14 int compare(const rational_key& lhs, const rational_key& rhs)
+    {
+        const std::size_t common = lhs.size_ < rhs.size_ ? lhs.size_ : rhs.size_;
+        for (std::size_t i = 0; i < common; ++i) {
+            if (lhs.bytes_[i] != rhs.bytes_[i]) {
+                return lhs.bytes_[i] < rhs.bytes_[i] ? -1 : 1;
+            }
+        }
+        return lhs.size_ == rhs.size_ ? 0 : lhs.size_ < rhs.size_ ? -1 : 1;
+    }
+
+    friend TCB_CONSTEXPR14 bool operator==(const rational_key& lhs, const rational_key& rhs)
+    {
+        return compare(lhs, rhs) == 0;
+    }
+
+    friend TCB_CONSTEXPR14 bool operator!=(const rational_key& lhs, const rational_key& rhs)
+    {
+        return compare(lhs, rhs) != 0;
+    }
+
+    friend TCB_CONSTEXPR14 bool operator<(const rational_key& lhs, const rational_key& rhs)
+    {
+        return compare(lhs, rhs) < 0;
+    }
+
+    friend TCB_CONSTEXPR14 bool operator>(const rational_key& lhs, const rational_key& rhs)
+    {
+        return compare(lhs, rhs) > 0;
+    }
+
+    friend TCB_CONSTEXPR14 bool operator<=(const rational_key& lhs, const rational_key& rhs)
+    {
+        return compare(lhs, rhs) <= 0;
+    }
+
+    friend TCB_CONSTEXPR14 bool operator>=(const rational_key& lhs, const rational_key& rhs)
+    {
+        return compare(lhs, rhs) >= 0;
+    }
+
+private:
+    unsigned char bytes_[capacity] = {};
+    std::size_t size_ = 0;
+};
+
+/*
+ * Writes the key of value to out, which must accept unsigned chars (or
+ * chars), and returns the end of the key. At most
+ * rational_key<T>::capacity bytes are written.
+ */
+template <typename T, typename OutputIt>
+TCB_CONSTEXPR14 OutputIt encode_key(const rational<T>& value, OutputIt out)
+{
+    if (value.num() == 0) {
+        *out++ = detail::key_zero;
+        return out;
+    }
+    const bool negative = value.num() < 0;
+    *out++ = negative ? detail::key_negative : detail::key_positive;
+
+    const unsigned char sign_mask = negative ? 0xFF : 0x00;
+    unsigned char position_mask = 0x00;
+    std::uint64_t num = detail::magnitude(value.num());
+    std::uint64_t denom = detail::magnitude(value.denom());
+    while (denom != 0) {
+        const std::uint64_t term = num / denom;
+        const std::uint64_t rem = num - term * denom;
+        out = detail::put_key_term(term, static_cast<unsigned char>(sign_mask ^ position_mask), out);
+        num = denom;
+        denom = rem;
+        position_mask = static_cast<unsigned char>(~position_mask);
+    }
+    *out++ = static_cast<unsigned char>(detail::key_end ^ sign_mask ^ position_mask);
+    return out;
+}
+
+template <typename T>
+constexpr std::size_t rational_key<T>::capacity;
+
+template <typename T>
+TCB_CONSTEXPR14 rational_key<T>::rational_key(const rational<T>& value)
+{
+    size_ = static_cast<std::size_t>(encode_key(value, bytes_) - bytes_);
+}
+
+template <typename T>
+TCB_CONSTEXPR14 rational_key<T> encode_key(const rational<T>& value)
+{
+    return rational_key<T>{value};
+}
+
+/*
+ * Decodes the size-byte key at data into result. Returns false, leaving
+ * result unchanged, if the bytes are not a key, or if the value does not
+ * fit in rational<T>.
+ */
+template <typename T>
+TCB_CONSTEXPR14 bool decode_key(const unsigned char* data, std::size_t size, rational<T>& result)
+{
+    if (size == 0) {
+        return false;
+    }
+    if (data[0] == detail::key_zero) {
+        if (size != 1) {
+            return false;
+        }
+        result = rational<T>{};
+        return true;
+    }
+    if (data[0] != detail::key_negative && data[0] != detail::key_positive) {
+        return false;
+    }
+    const bool negative = data[0] == detail::key_negative;
+    // Negative keys hold non-zero values, which an unsigned T cannot. (The
+    // limit checks below would miss those with a first term of zero.)
+    if (negative && !std::is_signed<T>::value) {
+        return false;
+    }
+    const std::uint64_t limit =
+            negative ? std::uint64_t{detail::magnitude(std::numeric_limits<T>::min())}
+                     : static_cast<std::uint64_t>(std::numeric_limits<T>::max());
+    const std::uint64_t denom_limit = static_cast<std::uint64_t>(std::numeric_limits<T>::max());
+
+    // The convergents p/q of the terms so far
+    std::uint64_t p = 1, q = 0;
+    std::uint64_t p_prev = 0, q_prev = 1;
+    std::uint64_t last_term = 0;
+    std::size_t terms = 0;
+    std::size_t pos = 1;
+    unsigned char mask = negative ? 0xFF : 0x00;
+    while (true) {
+        if (pos == size) {
+            return false;
+        }
+        const unsigned char lead = static_cast<unsigned char>(data[pos++] ^ mask);
+        if (lead == detail::key_end) {
+            break;
+        }
+        std::uint64_t term = lead;
+        if (lead >= detail::key_small_terms) {
+            const std::size_t length = lead - detail::key_small_terms;
+            if (size - pos < length) {
+                return false;
+            }
+            term = 0;
+            for (std::size_t i = 0; i < length; ++i) {
+                term = (term << 8) | static_cast<unsigned char>(data[pos++] ^ mask);
+            }
+            // Only the shortest coding of each term is valid
+            if (term < detail::key_small_terms || (term >> (8 * (length - 1))) == 0) {
+                return false;
+            }
+        }
+        if (terms > 0 && term == 0) {
+            return false;
+        }
+        // p = term p + p_prev, and likewise for q, failing past the limits
+        if ((p != 0 && term > (limit - p_prev) / p) ||
+            (q != 0 && term > (denom_limit - q_prev) / q)) {
+            return false;
+        }
+        const std::uint64_t next_p = term * p + p_prev;
+        const std::uint64_t next_q = term * q + q_prev;
+        p_prev = p;
+        q_prev = q;
+        p = next_p;
+        q = next_q;
+        last_term = term;
+        ++terms;
+        mask = static_cast<unsigned char>(~mask);
+    }
+    // The canonical expansion of a non-zero value
+    if (pos != size || terms == 0 || p == 0 || (terms > 1 && last_term == 1)) {
+        return false;
+    }
+    result = rational<T>{normalized, detail::apply_sign<T>(static_cast<std::make_unsigned_t<T>>(p), negative),
+                         static_cast<T>(q)};
+    return true;
+}
+
+template <typename T>
+TCB_CONSTEXPR14 bool decode_key(const rational_key<T>& key, rational<T>& result)
+{
+    return decode_key(key.data(), key.size(), result);
+}
+
+} // end namespace tcb
+
+#undef TCB_CONSTEXPR14
+
+#endif // TCB_RATIONAL_KEY_HPP_INCLUDED
@@ -0,0 +1,228 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_RATIONAL_MULTIPLIER_HPP_INCLUDED
+#define TCB_RATIONAL_MULTIPLIER_HPP_INCLUDED
+
+#include <tcb/rescale.hpp>
+
+#ifdef TCB_HAVE_CONSTEXPR14
+#define TCB_CONSTEXPR14 constexpr
+#else
+#define TCB_CONSTEXPR14
+#endif
+
+namespace tcb {
+
+template <typename T>
+struct divmod_result {
+    T quot;
+    T rem;
+};
+
+/*
+ * Repeated operations against a single rational r.
+ *
+ * Constructing a rational_multiplier precomputes a reciprocal of r's
+ * denominator, so that rounding x * r to an integer, or dividing x by the
+ * denominator, costs a few multiplications rather than a hardware divide.
+ * Products are formed in double width, so x * r.num() may exceed T; the
+ * final result must be representable in T.
+ */
+template <typename T>
+class rational_multiplier {
+public:
+    static_assert(std::is_integral<T>::value && sizeof(T) <= sizeof(std::uint64_t),
+                  "tcb::rational_multiplier<T> requires an integral type of up to 64 bits");
+
+    using value_type = T;
+
+    TCB_CONSTEXPR14 explicit rational_multiplier(const rational<T>& r)
+        : value_(r),
+          factor_{static_cast<word_type>(detail::magnitude(r.num())),
+                  static_cast<word_type>(r.denom()),
+                  r.num() < 0},
+          divider_(factor_.denom)
+    {}
+
+    constexpr const rational<T>& value() const { return value_; }
+
+    /* Scalar operations */
+
+    // x * r, rounded to an integer according to mode
+    TCB_CONSTEXPR14 T multiply(T x, rounding mode) const
+    {
+        const bool negative = (x < 0) != factor_.negative;
+        const auto p = detail::mul_wide(static_cast<word_type>(detail::magnitude(x)),
+                                        factor_.num);
+        word_type rem = 0;
+        const word_type q = divider_.divide(p.hi, p.lo, rem);
+        return detail::apply_sign<T>(
+                detail::round_quotient(q, rem, factor_.denom, negative, mode), negative);
+    }
+
+    TCB_CONSTEXPR14 T floor(T x) const { return multiply(x, rounding::down); }
+
+    TCB_CONSTEXPR14 T ceil(T x) const { return multiply(x, rounding::up); }
+
+    TCB_CONSTEXPR14 T round(T x) const { return multiply(x, rounding::nearest); }
+
+    // x / r.denom() and x % r.denom(), truncating as the built-in operators do
+    TCB_CONSTEXPR14 divmod_result<T> divmod(T x) const
+    {
+        const bool negative = x < 0;
+        word_type rem = 0;
+        const word_type q = divider_.divide(
+                0, static_cast<word_type>(detail::magnitude(x)), rem);
+        return {detail::apply_sign<T>(q, negative), detail::apply_sign<T>(rem, negative)};
+    }
+
+    // Returns a negative value, zero or a positive value as x is less than,
+    // equal to or greater than r. No division is required.
+    TCB_CONSTEXPR14 int compare(T x) const
+    {
+        const bool x_negative = x < 0;
+        if (x_negative != factor_.negative) {
+            return x_negative ? -1 : 1;
+        }
+        // Same sign: compare |x| * denom against |num|
+        const auto p = detail::mul_wide(static_cast<word_type>(detail::magnitude(x)),
+                                        factor_.denom);
+        const int mag_cmp = p.hi != 0 ? 1 :
+                            p.lo > factor_.num ? 1 :
+                            p.lo < factor_.num ? -1 : 0;
+        return x_negative ? -mag_cmp : mag_cmp;
+    }
+
+    /* Batch operations */
+
+    // Writes x * r for each x in [first, last) to out, rounded according to
+    // mode. Returns an iterator past the last element written.
+    template <typename InputIt, typename OutputIt>
+    OutputIt multiply(InputIt first, InputIt last, OutputIt out, rounding mode) const
+    {
+        static_assert(sizeof(typename std::iterator_traits<InputIt>::value_type) <= sizeof(T),
+                      "Input values must be no wider than the multiplier's value type");
+        return detail::rescale_batch(first, last, out, factor_, divider_, mode);
+    }
+
+    template <typename InputIt, typename OutputIt>
+    OutputIt floor(InputIt first, InputIt last, OutputIt out) const
+    {
+        return multiply(first, last, out, rounding::down);
+    }
+
+    template <typename InputIt, typename OutputIt>
+    OutputIt ceil(InputIt first, InputIt last, OutputIt out) const
+    {
+        return multiply(first, last, out, rounding::up);
+    }
+
+    template <typename InputIt, typename OutputIt>
+    OutputIt round(InputIt first, InputIt last, OutputIt out) const
+    {
+        return multiply(first, last, out, rounding::nearest);
+    }
+
+    // Writes the quotients and remainders of each x in [first, last)
+    // divided by r.denom() to quot_out and rem_out respectively
+    template <typename InputIt, typename QuotIt, typename RemIt>
+    void divmod(InputIt first, InputIt last, QuotIt quot_out, RemIt rem_out) const
+    {
+        for (; first != last; ++first, ++quot_out, ++rem_out) {
+            const auto res = divmod(static_cast<T>(*first));
+            *quot_out = res.quot;
+            *rem_out = res.rem;
+        }
+    }
+
+private:
+    using word_type = detail::unsigned_word_t<T>;
+
+    rational<T> value_;
+    detail::rescale_factor<word_type> factor_;
+    detail::invariant_divider<word_type> divider_;
+};
+
+namespace detail {
+
+template <std::intmax_t Num, std::intmax_t Denom, typename T>
+TCB_CONSTEXPR14 T static_scale(T x, rounding mode)
+{
+    static_assert(std::is_integral<T>::value && sizeof(T) <= sizeof(std::uint64_t),
+                  "tcb::static_scale() supports integers of up to 64 bits");
+    static_assert(Denom > 0, "tcb::static_scale() requires a positive denominator");
+    // A constant too large for T's word takes the 64-bit one
+    using word_type = std::conditional_t<
+            (magnitude(Num) <= std::numeric_limits<unsigned_word_t<T>>::max() &&
+             static_cast<std::uintmax_t>(Denom) <= std::numeric_limits<unsigned_word_t<T>>::max()),
+            unsigned_word_t<T>, std::uint64_t>;
+
+    constexpr word_type num = static_cast<word_type>(magnitude(Num));
+    constexpr word_type denom = static_cast<word_type>(Denom);
+    constexpr bool denom_is_pow2 = (denom & (denom - 1)) == 0;
+    constexpr int shift = word_digits<word_type>::value - 1 - count_leading_zeros(denom);
+
+    const bool negative = (x < 0) != (Num < 0);
+    const word_type mag = static_cast<word_type>(magnitude(x));
+
+    if (denom == 1) {
+        return apply_sign<T>(static_cast<word_type>(mag * num), negative);
+    }
+
+    const double_word<word_type> p = mul_wide(mag, num);
+    word_type q = 0;
+    word_type rem = 0;
+    if (denom_is_pow2) {
+        q = static_cast<word_type>((p.lo >> shift) | ((p.hi << 1) << (word_digits<word_type>::value - 1 - shift)));
+        rem = static_cast<word_type>(p.lo & (denom - 1));
+    } else if (sizeof(word_type) < sizeof(std::uint64_t)) {
+        // The compiler lowers division of a 64-bit value by a constant to a
+        // multiply-high and shift
+        const std::uint64_t n = (static_cast<std::uint64_t>(p.hi) << 32) | p.lo;
+        q = static_cast<word_type>(n / denom);
+        rem = static_cast<word_type>(n % denom);
+    } else {
+        // ...but not a 128-bit value, so use a reciprocal computed at compile
+        // time instead
+        constexpr invariant_divider<word_type> divider(denom);
+        q = divider.divide(p.hi, p.lo, rem);
+    }
+    return apply_sign<T>(round_quotient(q, rem, denom, negative, mode), negative);
+}
+
+} // end namespace detail
+
+/*
+ * Computes x * R for a rational constant R given as a std::ratio (or, in
+ * C++20, as a rational<T> value), rounding as requested. The product is
+ * exact, and the division by R's denominator is performed by multiplication
+ * with a compile-time reciprocal rather than a divide instruction.
+ *
+ * Precondition: the rounded result is representable in T.
+ */
+template <typename Ratio, typename T>
+TCB_CONSTEXPR14 T static_scale(T x, rounding mode = rounding::toward_zero)
+{
+    return detail::static_scale<Ratio::num, Ratio::den>(x, mode);
+}
+
+#ifdef TCB_RATIONAL_STRUCTURAL
+
+template <auto R, typename T>
+constexpr T static_scale(T x, rounding mode = rounding::toward_zero)
+{
+    static_assert(is_rational_v<std::remove_cv_t<decltype(R)>>,
+                  "tcb::static_scale<R>() requires a rational constant");
+    return detail::static_scale<numerator(R), denominator(R)>(x, mode);
+}
+
+#endif // TCB_RATIONAL_STRUCTURAL
+
+} // end namespace tcb
+
+#undef TCB_CONSTEXPR14
+
+#endif // TCB_RATIONAL_MULTIPLIER_HPP_INCLUDED
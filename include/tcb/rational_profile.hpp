@@ -0,0 +1,394 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_RATIONAL_PROFILE_HPP_INCLUDED
+#define TCB_RATIONAL_PROFILE_HPP_INCLUDED
+
+/*
+ * Operand size profiling for rational<T>.
+ *
+ * When TCB_RATIONAL_PROFILE is defined (consistently, in every translation
+ * unit), rational.hpp samples the result of every arithmetic operation and
+ * reducing construction, recording the bit lengths of |num| and denom in
+ * log2 histograms. Results are attributed to the innermost
+ * rational_profile_scope on the calling thread, so a scope can name a call
+ * site, a request type or a subsystem.
+ *
+ * One result in every rational_profile_interval() is recorded (64 by
+ * default, or TCB_RATIONAL_PROFILE_INTERVAL), so that the cost of the
+ * profiler is a thread-local countdown on most operations.
+ *
+ * The profile can be written as text (which read_rational_profile() parses
+ * back) or JSON. recommend_rational_width() suggests the narrowest
+ * rational<T> able to hold the recorded values, as does the
+ * rational_width_advisor tool.
+ *
+ * The reading and recommendation functions do not need TCB_RATIONAL_PROFILE,
+ * so that tools can use them.
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+#include <istream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#ifndef TCB_RATIONAL_PROFILE_INTERVAL
+#define TCB_RATIONAL_PROFILE_INTERVAL 64
+#endif
+
+namespace tcb {
+
+// Histograms of bit lengths: element i counts values with i significant bits
+struct rational_profile_histogram {
+    static constexpr int max_bits = 128;
+
+    std::uint64_t samples = 0;
+    std::array<std::uint64_t, max_bits + 1> num_bits{};
+    std::array<std::uint64_t, max_bits + 1> denom_bits{};
+
+    // The largest bit length recorded, or -1 if there are no samples
+    int max_num_bits() const { return highest(num_bits); }
+
+    int max_denom_bits() const { return highest(denom_bits); }
+
+private:
+    static int highest(const std::array<std::uint64_t, max_bits + 1>& bits)
+    {
+        for (int i = max_bits; i >= 0; --i) {
+            if (bits[i] != 0) {
+                return i;
+            }
+        }
+        return -1;
+    }
+};
+
+struct rational_profile {
+    unsigned interval = TCB_RATIONAL_PROFILE_INTERVAL;
+    std::map<std::string, rational_profile_histogram> tags;
+};
+
+enum class rational_profile_format { text, json };
+
+namespace detail {
+
+struct profile_state {
+    std::mutex mutex;
+    rational_profile profile;
+    std::atomic<unsigned> interval{TCB_RATIONAL_PROFILE_INTERVAL};
+};
+
+inline profile_state& global_profile()
+{
+    static profile_state state;
+    return state;
+}
+
+inline const char*& current_profile_tag()
+{
+    thread_local const char* tag = "(untagged)";
+    return tag;
+}
+
+// Each thread samples its first result, then one in every interval
+inline unsigned& profile_countdown()
+{
+    thread_local unsigned countdown = 1;
+    return countdown;
+}
+
+template <typename T>
+int bit_length(T value)
+{
+    using unsigned_type = std::make_unsigned_t<T>;
+    auto mag = static_cast<unsigned_type>(value);
+    if (value < 0) {
+        mag = static_cast<unsigned_type>(0u - mag);
+    }
+    int bits = 0;
+    for (; mag != 0; mag >>= 1) {
+        ++bits;
+    }
+    return bits;
+}
+
+inline void profile_record(int num_bits, int denom_bits)
+{
+    auto& state = global_profile();
+    std::lock_guard<std::mutex> lock{state.mutex};
+    auto& hist = state.profile.tags[current_profile_tag()];
+    ++hist.samples;
+    ++hist.num_bits[num_bits];
+    ++hist.denom_bits[denom_bits];
+}
+
+// Called by rational<T>::simplify() with the reduced result
+template <typename T>
+void profile_sample(T num, T denom)
+{
+    unsigned& countdown = profile_countdown();
+    if (--countdown > 0) {
+        return;
+    }
+    countdown = global_profile().interval.load(std::memory_order_relaxed);
+    profile_record(bit_length(num), bit_length(denom));
+}
+
+inline void write_json_string(std::ostream& os, const std::string& str)
+{
+    os << '"';
+    for (const char c : str) {
+        if (c == '"' || c == '\\') {
+            os << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            const char* hex = "0123456789abcdef";
+            os << "\\u00" << hex[(c >> 4) & 0xf] << hex[c & 0xf];
+        } else {
+            os << c;
+        }
+    }
+    os << '"';
+}
+
+inline void write_json_histogram(std::ostream& os,
+                                 const std::array<std::uint64_t,
+                                                  rational_profile_histogram::max_bits + 1>& bits)
+{
+    os << '{';
+    bool first = true;
+    for (std::size_t i = 0; i < bits.size(); ++i) {
+        if (bits[i] != 0) {
+            os << (first ? "" : ", ") << '"' << i << "\": " << bits[i];
+            first = false;
+        }
+    }
+    os << '}';
+}
+
+} // end namespace detail
+
+/*
+ * Attributes operations on this thread to tag for the lifetime of the
+ * scope. tag must outlive the scope; string literals are typical.
+ */
+class rational_profile_scope {
+public:
+    explicit rational_profile_scope(const char* tag)
+        : previous_(detail::current_profile_tag())
+    {
+        detail::current_profile_tag() = tag;
+    }
+
+    ~rational_profile_scope() { detail::current_profile_tag() = previous_; }
+
+    rational_profile_scope(const rational_profile_scope&) = delete;
+    rational_profile_scope& operator=(const rational_profile_scope&) = delete;
+
+private:
+    const char* previous_;
+};
+
+// Records one result in every interval. Threads pick up the new interval
+// after their next sample.
+inline void set_rational_profile_interval(unsigned interval)
+{
+    detail::global_profile().interval.store(interval > 0 ? interval : 1,
+                                            std::memory_order_relaxed);
+}
+
+inline unsigned rational_profile_interval()
+{
+    return detail::global_profile().interval.load(std::memory_order_relaxed);
+}
+
+inline rational_profile rational_profile_snapshot()
+{
+    auto& state = detail::global_profile();
+    std::lock_guard<std::mutex> lock{state.mutex};
+    rational_profile result = state.profile;
+    result.interval = rational_profile_interval();
+    return result;
+}
+
+inline void reset_rational_profile()
+{
+    auto& state = detail::global_profile();
+    std::lock_guard<std::mutex> lock{state.mutex};
+    state.profile.tags.clear();
+}
+
+/*
+ * Text format, one item per line:
+ *
+ *   interval <n>
+ *   tag <name>
+ *   samples <count>
+ *   num <bits> <count>
+ *   denom <bits> <count>
+ *
+ * where each tag is followed by its samples, num and denom lines. Empty
+ * histogram buckets are omitted.
+ */
+inline void write_rational_profile(std::ostream& os, const rational_profile& profile,
+                                   rational_profile_format format = rational_profile_format::text)
+{
+    if (format == rational_profile_format::json) {
+        os << "{\"interval\": " << profile.interval << ", \"tags\": {";
+        bool first = true;
+        for (const auto& entry : profile.tags) {
+            os << (first ? "\n  " : ",\n  ");
+            detail::write_json_string(os, entry.first);
+            os << ": {\"samples\": " << entry.second.samples << ", \"num_bits\": ";
+            detail::write_json_histogram(os, entry.second.num_bits);
+            os << ", \"denom_bits\": ";
+            detail::write_json_histogram(os, entry.second.denom_bits);
+            os << '}';
+            first = false;
+        }
+        os << "\n}}\n";
+        return;
+    }
+
+    os << "interval " << profile.interval << '\n';
+    for (const auto& entry : profile.tags) {
+        const auto& hist = entry.second;
+        os << "tag " << entry.first << '\n';
+        os << "samples " << hist.samples << '\n';
+        for (std::size_t i = 0; i < hist.num_bits.size(); ++i) {
+            if (hist.num_bits[i] != 0) {
+                os << "num " << i << ' ' << hist.num_bits[i] << '\n';
+            }
+        }
+        for (std::size_t i = 0; i < hist.denom_bits.size(); ++i) {
+            if (hist.denom_bits[i] != 0) {
+                os << "denom " << i << ' ' << hist.denom_bits[i] << '\n';
+            }
+        }
+    }
+}
+
+// Writes the profile recorded so far
+inline void dump_rational_profile(std::ostream& os,
+                                  rational_profile_format format = rational_profile_format::text)
+{
+    write_rational_profile(os, rational_profile_snapshot(), format);
+}
+
+// Parses the text format. Returns false if the input is malformed.
+inline bool read_rational_profile(std::istream& is, rational_profile& profile)
+{
+    profile = rational_profile{};
+    rational_profile_histogram* current = nullptr;
+    std::string line;
+    while (std::getline(is, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        std::istringstream ss{line};
+        std::string key;
+        ss >> key;
+        if (key == "tag") {
+            std::string name = line.size() > 4 ? line.substr(4) : std::string{};
+            current = &profile.tags[name];
+            continue;
+        }
+        if (key == "interval") {
+            if (!(ss >> profile.interval)) {
+                return false;
+            }
+            continue;
+        }
+        if (current == nullptr) {
+            return false;
+        }
+        if (key == "samples") {
+            if (!(ss >> current->samples)) {
+                return false;
+            }
+        } else if (key == "num" || key == "denom") {
+            std::size_t bits = 0;
+            std::uint64_t count = 0;
+            if (!(ss >> bits >> count) || bits > rational_profile_histogram::max_bits) {
+                return false;
+            }
+            (key == "num" ? current->num_bits : current->denom_bits)[bits] += count;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Width recommendation.
+ *
+ * With the default promote_result_policy, rational<T>'s binary operators
+ * form products such as num1 * denom2 + num2 * denom1 in T (or int, for
+ * types narrower than int). Operands of b bits therefore need T to have at
+ * least 2b + 1 value bits. With preserve_result_policy the products are
+ * formed in a type twice as wide, so b value bits suffice. For 64-bit
+ * types that needs 128-bit integers; without them, preserve_result_policy
+ * forms 64-bit products in 64 bits and needs 2b + 1 bits as well.
+ *
+ * Profiles are sampled, so a margin of extra bits is added to the largest
+ * observed length to allow for values which were not seen.
+ */
+namespace detail {
+
+// Whether preserve_result_policy forms products of 64-bit operands in 128
+// bits, as detail::has_double_width_v<std::int64_t> in rational.hpp
+#ifdef __SIZEOF_INT128__
+__extension__ constexpr bool profile_has_int128 = std::is_integral<__int128>::value;
+#else
+constexpr bool profile_has_int128 = false;
+#endif
+
+} // end namespace detail
+
+struct rational_width_recommendation {
+    int max_bits = 0;           // largest observed bit length, num or denom
+    int promote_bits = 0;       // width needed with promote_result_policy
+    int preserve_bits = 0;      // width needed with preserve_result_policy
+};
+
+inline rational_width_recommendation
+recommend_rational_width(const rational_profile_histogram& hist, int margin_bits = 2)
+{
+    rational_width_recommendation rec;
+    rec.max_bits = std::max(hist.max_num_bits(), hist.max_denom_bits());
+    if (rec.max_bits < 0) {
+        rec.max_bits = 0;
+    }
+    const int needed = rec.max_bits + margin_bits;
+    // Value bits plus a sign bit, rounded up to a standard width
+    const auto standard_width = [](int value_bits) {
+        for (int width : {8, 16, 32, 64, 128}) {
+            if (value_bits + 1 <= width) {
+                return width;
+            }
+        }
+        return 0;
+    };
+    rec.promote_bits = standard_width(2 * needed + 1);
+    rec.preserve_bits = standard_width(needed);
+    if (rec.preserve_bits > 32 && !detail::profile_has_int128) {
+        rec.preserve_bits = rec.promote_bits;
+    }
+    return rec;
+}
+
+} // end namespace tcb
+
+#endif // TCB_RATIONAL_PROFILE_HPP_INCLUDED
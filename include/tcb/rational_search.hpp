@@ -0,0 +1,196 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_RATIONAL_SEARCH_HPP_INCLUDED
+#define TCB_RATIONAL_SEARCH_HPP_INCLUDED
+
+/*
+ * Searches over the rationals.
+ *
+ *   simplest_between(lo, hi)          the rational in [lo, hi] with the
+ *                                     smallest denominator, and of those the
+ *                                     one nearest zero
+ *   stern_brocot_search(pred, max)    the smallest non-negative rational with
+ *                                     denominator at most max for which the
+ *                                     monotone predicate pred is true
+ *
+ * Both descend the Stern-Brocot tree a run at a time rather than a node at
+ * a time: simplest_between() takes each run length from a continued
+ * fraction term of the bounds, and stern_brocot_search() finds it by
+ * exponential and then binary search. The cost is therefore logarithmic in
+ * the size of the answer rather than proportional to it.
+ *
+ * Every intermediate value is bounded by the inputs or the answer, so
+ * neither function can overflow T.
+ */
+
+#include <tcb/rational.hpp>
+
+#include <limits>
+
+#ifdef TCB_HAVE_CONSTEXPR14
+#define TCB_CONSTEXPR14 constexpr
+#else
+#define TCB_CONSTEXPR14
+#endif
+
+namespace tcb {
+
+namespace detail {
+
+// simplest_between() for 0 < a/b <= c/d. The terms of the answer's
+// continued fraction are those shared by the bounds, followed by the
+// smallest integer in the remaining interval.
+template <typename T>
+TCB_CONSTEXPR14 rational<T> simplest_between_positive(T a, T b, T c, T d)
+{
+    T p = 1, q = 0;            // the convergent so far
+    T p_prev = 0, q_prev = 1;  // and the one before it
+    while (true) {
+        const T term = a / b;
+        const T rem = a - term * b;
+        // Stop at an integer in [a/b, c/d]: floor(a/b) if it is a/b, or
+        // floor(a/b) + 1 if that is no more than c/d
+        const bool stop = rem == 0 || c / d > term;
+        const T last = stop && rem != 0 ? static_cast<T>(term + 1) : term;
+        const T next_p = static_cast<T>(last * p + p_prev);
+        const T next_q = static_cast<T>(last * q + q_prev);
+        if (stop) {
+            return rational<T>{normalized, next_p, next_q};
+        }
+        p_prev = p;
+        q_prev = q;
+        p = next_p;
+        q = next_q;
+        // Both bounds lie in (term, term + 1); recurse on the reciprocals
+        // of their fractional parts, which swaps them
+        const T c_rem = static_cast<T>(c - term * d);
+        c = b;
+        b = c_rem;
+        a = d;
+        d = rem;
+    }
+}
+
+// The largest k in [1, max_k] for which test(k) holds, given that test(1)
+// does and that test is monotone
+template <typename T, typename Test>
+TCB_CONSTEXPR14 T gallop(Test& test, T max_k)
+{
+    T lo = 1;
+    T hi = 1;
+    // Double until test fails or the limit is passed
+    while (true) {
+        if (hi > max_k / 2) {
+            hi = max_k;
+            if (hi == lo || test(hi)) {
+                return hi;
+            }
+            break;
+        }
+        hi = static_cast<T>(hi * 2);
+        if (!test(hi)) {
+            break;
+        }
+        lo = hi;
+    }
+    // test(lo) holds and test(hi) does not
+    while (hi - lo > 1) {
+        const T mid = static_cast<T>(lo + (hi - lo) / 2);
+        if (test(mid)) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// The largest k for which base + k step fits, with denominator at most
+// max_denom
+template <typename T>
+TCB_CONSTEXPR14 T max_steps(T base_num, T base_denom, T step_num, T step_denom, T max_denom)
+{
+    T k = std::numeric_limits<T>::max();
+    if (step_denom > 0) {
+        k = max_denom < base_denom ? T{0} : static_cast<T>((max_denom - base_denom) / step_denom);
+    }
+    if (step_num > 0) {
+        const T limit = static_cast<T>((std::numeric_limits<T>::max() - base_num) / step_num);
+        k = limit < k ? limit : k;
+    }
+    return k;
+}
+
+} // end namespace detail
+
+/*
+ * Returns the simplest rational in the closed interval [lo, hi]: the one
+ * with the smallest denominator, and among those the one with the smallest
+ * absolute value. Requires lo <= hi.
+ *
+ * For example, simplest_between(29965/1000_r, 29975/1000_r) is 869/29.
+ */
+template <typename T>
+TCB_CONSTEXPR14 rational<T> simplest_between(const rational<T>& lo, const rational<T>& hi)
+{
+    if (lo.num() <= 0 && hi.num() >= 0) {
+        return rational<T>{};
+    }
+    if (hi.num() < 0) {
+        return -detail::simplest_between_positive(static_cast<T>(-hi.num()), hi.denom(),
+                                                  static_cast<T>(-lo.num()), lo.denom());
+    }
+    return detail::simplest_between_positive(lo.num(), lo.denom(), hi.num(), hi.denom());
+}
+
+/*
+ * Returns the smallest rational x >= 0 with denominator at most max_denom
+ * for which pred(x) is true, where pred is monotone: false up to some
+ * point and true from then on. If pred is false for every candidate up to
+ * numeric_limits<T>::max(), returns numeric_limits<T>::max().
+ *
+ * The search keeps neighbouring bounds L < R with pred(L) false and pred(R)
+ * true (starting from 0/1 and 1/0), and replaces one of them by their
+ * mediant until the mediant's denominator would exceed max_denom. Runs of
+ * moves in the same direction, to kL + R or L + kR, are found in
+ * O(log k) calls to pred.
+ */
+template <typename T, typename Pred>
+TCB_CONSTEXPR14 rational<T> stern_brocot_search(Pred pred, T max_denom)
+{
+    if (pred(rational<T>{})) {
+        return rational<T>{};
+    }
+    T a = 0, b = 1;  // L, for which pred is false
+    T c = 1, d = 0;  // R, for which pred is true
+    while (b <= max_denom && d <= max_denom - b && a <= std::numeric_limits<T>::max() - c) {
+        if (pred(rational<T>{normalized, T(a + c), T(b + d)})) {
+            // Move R towards L
+            auto test = [&](T k) {
+                return pred(rational<T>{normalized, T(k * a + c), T(k * b + d)});
+            };
+            const T k = detail::gallop(test, detail::max_steps(c, d, a, b, max_denom));
+            c = static_cast<T>(k * a + c);
+            d = static_cast<T>(k * b + d);
+        } else {
+            // Move L towards R
+            auto test = [&](T k) {
+                return !pred(rational<T>{normalized, T(a + k * c), T(b + k * d)});
+            };
+            const T k = detail::gallop(test, detail::max_steps(a, b, c, d, max_denom));
+            a = static_cast<T>(a + k * c);
+            b = static_cast<T>(b + k * d);
+        }
+    }
+    return d == 0 ? rational<T>{std::numeric_limits<T>::max()}
+                  : rational<T>{normalized, c, d};
+}
+
+} // end namespace tcb
+
+#undef TCB_CONSTEXPR14
+
+#endif // TCB_RATIONAL_SEARCH_HPP_INCLUDED
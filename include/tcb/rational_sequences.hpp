@@ -0,0 +1,445 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_RATIONAL_SEQUENCES_HPP_INCLUDED
+#define TCB_RATIONAL_SEQUENCES_HPP_INCLUDED
+
+/*
+ * Enumeration of reduced fractions.
+ *
+ *   farey_sequence(n)              the fractions in [0, 1] with denominators
+ *                                  at most n, in ascending order
+ *   farey_sequence(n, first, last) those with denominators at most n in
+ *                                  [first, last)
+ *   farey_sequence_chunk(n, i, k)  the i'th of k disjoint pieces of
+ *                                  farey_sequence(n)
+ *   calkin_wilf_sequence<T>(n)     the first n positive rationals in
+ *                                  Calkin-Wilf (breadth-first) order
+ *   stern_brocot_sequence<T>(d)    the nodes of the Stern-Brocot tree down to
+ *                                  depth d, in ascending order
+ *
+ * Every element is generated from its predecessors with a few multiplies
+ * and divides, and is already in lowest terms, so none needs a GCD. Like the
+ * views in continued_fraction.hpp, these are lazy forward ranges which
+ * allocate nothing, and borrowed ranges in C++20.
+ *
+ * Farey chunks are independent views, so worker threads can enumerate
+ * farey_sequence_chunk(n, i, k) for each i in parallel. The fractions have
+ * uniform density, so the chunks are of similar length.
+ */
+
+#include <tcb/continued_fraction.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+#ifdef TCB_HAVE_CONSTEXPR14
+#define TCB_CONSTEXPR14 constexpr
+#else
+#define TCB_CONSTEXPR14
+#endif
+
+namespace tcb {
+
+namespace detail {
+
+// Finds x and y with a x + b y = gcd(a, b), where b > 0 and |x| <= b, |y| <= |a|
+template <typename T>
+TCB_CONSTEXPR14 void extended_gcd(T a, T b, T& x, T& y)
+{
+    T x0 = 1, y0 = 0, x1 = 0, y1 = 1;
+    while (b != 0) {
+        const T q = a / b;
+        T tmp = a - q * b;
+        a = b;
+        b = tmp;
+        tmp = x0 - q * x1;
+        x0 = x1;
+        x1 = tmp;
+        tmp = y0 - q * y1;
+        y0 = y1;
+        y1 = tmp;
+    }
+    x = a < 0 ? -x0 : x0;
+    y = a < 0 ? -y0 : y0;
+}
+
+} // end namespace detail
+
+/*
+ * Consecutive fractions a/b < c/d with denominators at most n are
+ * neighbours (b c - a d = 1), and the next fraction after them is
+ *
+ *   (k c - a)/(k d - b),   k = floor((n + b)/d)
+ *
+ * Intermediate values are at most 2n times the largest element, so T must
+ * be able to represent 2n(last + 1).
+ */
+template <typename T>
+class farey_sequence_view
+    : public detail::view_base<farey_sequence_view<T>> {
+    static_assert(std::is_signed<T>::value,
+                  "Farey sequences need a signed type");
+
+public:
+    class iterator {
+    public:
+        using value_type = rational<T>;
+        using reference = rational<T>;
+        using pointer = void;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::input_iterator_tag;
+        using iterator_concept = std::forward_iterator_tag;
+
+        constexpr iterator() = default;
+
+        // Positions the iterator at first, which must have denominator at
+        // most order
+        TCB_CONSTEXPR14 iterator(T order, const rational<T>& first)
+            : order_(order),
+              a_(first.num()),
+              b_(first.denom())
+        {
+            // The next fraction c/d is the neighbour b c - a d = 1 with the
+            // largest d <= order
+            T x = 0, y = 0;
+            detail::extended_gcd(a_, b_, x, y);
+            const T t = (order + x) / b_;
+            c_ = static_cast<T>(y + a_ * t);
+            d_ = static_cast<T>(b_ * t - x);
+        }
+
+        constexpr rational<T> operator*() const
+        {
+            return rational<T>{normalized, a_, b_};
+        }
+
+        TCB_CONSTEXPR14 iterator& operator++()
+        {
+            const T k = (order_ + b_) / d_;
+            const T e = static_cast<T>(k * c_ - a_);
+            const T f = static_cast<T>(k * d_ - b_);
+            a_ = c_;
+            b_ = d_;
+            c_ = e;
+            d_ = f;
+            return *this;
+        }
+
+        TCB_CONSTEXPR14 iterator operator++(int)
+        {
+            iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend constexpr bool operator==(const iterator& lhs, const iterator& rhs)
+        {
+            return lhs.a_ == rhs.a_ && lhs.b_ == rhs.b_;
+        }
+
+        friend constexpr bool operator!=(const iterator& lhs, const iterator& rhs)
+        {
+            return !(lhs == rhs);
+        }
+
+    private:
+        friend class farey_sequence_view;
+
+        T order_ = 1;
+        T a_ = 0;
+        T b_ = 1;
+        T c_ = 1;
+        T d_ = 1;
+    };
+
+    constexpr farey_sequence_view() = default;
+
+    // The elements of [first, last), both of which must have denominators at
+    // most order
+    constexpr farey_sequence_view(T order, const rational<T>& first, const rational<T>& last)
+        : order_(order), first_(first), last_(last)
+    {}
+
+    // The whole sequence, ending with 1/1. (n + 1)/n follows 1/1.
+    constexpr explicit farey_sequence_view(T order)
+        : farey_sequence_view(order, rational<T>{}, rational<T>{normalized, T(order + 1), order})
+    {}
+
+    constexpr T order() const { return order_; }
+
+    TCB_CONSTEXPR14 iterator begin() const { return iterator{order_, first_}; }
+
+    // Only the position of an iterator takes part in comparisons, so the
+    // end iterator need not know its successor
+    TCB_CONSTEXPR14 iterator end() const
+    {
+        iterator it;
+        it.a_ = last_.num();
+        it.b_ = last_.denom();
+        return it;
+    }
+
+private:
+    T order_ = 1;
+    rational<T> first_{};
+    rational<T> last_{1};
+};
+
+template <typename T>
+constexpr farey_sequence_view<T> farey_sequence(T order)
+{
+    return farey_sequence_view<T>{order};
+}
+
+template <typename T>
+constexpr farey_sequence_view<T> farey_sequence(T order, const rational<T>& first,
+                                                const rational<T>& last)
+{
+    return farey_sequence_view<T>{order, first, last};
+}
+
+// The elements of farey_sequence(order) in [index/parts, (index + 1)/parts),
+// or in [index/parts, 1] for the last chunk. Requires 0 < parts <= order,
+// so that every boundary is an element of the sequence.
+template <typename T>
+constexpr farey_sequence_view<T> farey_sequence_chunk(T order, T index, T parts)
+{
+    return farey_sequence_view<T>{
+            order, rational<T>{index, parts},
+            index + 1 == parts ? rational<T>{normalized, T(order + 1), order}
+                               : rational<T>{T(index + 1), parts}};
+}
+
+/*
+ * Each positive rational appears exactly once in the Calkin-Wilf sequence
+ *
+ *   1/1, 1/2, 2/1, 1/3, 3/2, 2/3, 3/1, 1/4, ...
+ *
+ * in which x is followed by 1/(2 floor(x) - x + 1). The numerators and
+ * denominators of the first 2^k elements are at most the (k + 1)'th
+ * Fibonacci number.
+ */
+template <typename T>
+class calkin_wilf_view
+    : public detail::view_base<calkin_wilf_view<T>> {
+public:
+    class iterator {
+    public:
+        using value_type = rational<T>;
+        using reference = rational<T>;
+        using pointer = void;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::input_iterator_tag;
+        using iterator_concept = std::forward_iterator_tag;
+
+        constexpr iterator() = default;
+
+        constexpr explicit iterator(std::size_t index) : index_(index) {}
+
+        constexpr rational<T> operator*() const
+        {
+            return rational<T>{normalized, a_, b_};
+        }
+
+        TCB_CONSTEXPR14 iterator& operator++()
+        {
+            const T next = static_cast<T>((2 * (a_ / b_) + 1) * b_ - a_);
+            a_ = b_;
+            b_ = next;
+            ++index_;
+            return *this;
+        }
+
+        TCB_CONSTEXPR14 iterator operator++(int)
+        {
+            iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend constexpr bool operator==(const iterator& lhs, const iterator& rhs)
+        {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend constexpr bool operator!=(const iterator& lhs, const iterator& rhs)
+        {
+            return !(lhs == rhs);
+        }
+
+    private:
+        std::size_t index_ = 0;
+        T a_ = 1;
+        T b_ = 1;
+    };
+
+    constexpr calkin_wilf_view() = default;
+
+    constexpr explicit calkin_wilf_view(std::size_t count) : count_(count) {}
+
+    constexpr iterator begin() const { return iterator{0}; }
+
+    constexpr iterator end() const { return iterator{count_}; }
+
+    constexpr std::size_t size() const { return count_; }
+
+private:
+    std::size_t count_ = 0;
+};
+
+template <typename T>
+constexpr calkin_wilf_view<T> calkin_wilf_sequence(std::size_t count)
+{
+    return calkin_wilf_view<T>{count};
+}
+
+/*
+ * In-order traversal of the Stern-Brocot tree, whose root 1/1 is at depth
+ * zero. Each node is the mediant of its bounds L and R, the nearest
+ * ancestors to its left and right (with 0/1 and 1/0 bounding the root).
+ *
+ * The successor of an interior node m = L + R is the leftmost deepest node
+ * of its right subtree, and that of a leaf is R, whose own bounds can be
+ * recovered from L and R: descending from R to the leaf took one step left
+ * and then j steps right, leaving L = L_R + j R. So the traversal needs no
+ * stack.
+ *
+ * Numerators and denominators are at most the (depth + 2)'th Fibonacci
+ * number.
+ */
+template <typename T>
+class stern_brocot_view
+    : public detail::view_base<stern_brocot_view<T>> {
+public:
+    class iterator {
+    public:
+        using value_type = rational<T>;
+        using reference = rational<T>;
+        using pointer = void;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::input_iterator_tag;
+        using iterator_concept = std::forward_iterator_tag;
+
+        constexpr iterator() = default;
+
+        // The leftmost node at the maximum depth is 1/(depth + 1), bounded
+        // by 0/1 and 1/depth
+        constexpr explicit iterator(int max_depth)
+            : lp_(0), lq_(1), rp_(1), rq_(static_cast<T>(max_depth)),
+              depth_(max_depth), max_depth_(max_depth),
+              at_end_(max_depth < 0)
+        {}
+
+        constexpr rational<T> operator*() const
+        {
+            return rational<T>{normalized, T(lp_ + rp_), T(lq_ + rq_)};
+        }
+
+        TCB_CONSTEXPR14 iterator& operator++()
+        {
+            if (depth_ < max_depth_) {
+                // Right once, then left to the maximum depth
+                const T mp = static_cast<T>(lp_ + rp_);
+                const T mq = static_cast<T>(lq_ + rq_);
+                const T t = static_cast<T>(max_depth_ - depth_ - 1);
+                lp_ = mp;
+                lq_ = mq;
+                rp_ = static_cast<T>(t * mp + rp_);
+                rq_ = static_cast<T>(t * mq + rq_);
+                depth_ = max_depth_;
+            } else if (rq_ == 0) {
+                // The rightmost leaf
+                at_end_ = true;
+            } else {
+                // Up to R
+                const T j = std::min(static_cast<T>(lp_ / rp_), static_cast<T>(lq_ / rq_));
+                lp_ = static_cast<T>(lp_ - j * rp_);
+                lq_ = static_cast<T>(lq_ - j * rq_);
+                rp_ = static_cast<T>(rp_ - lp_);
+                rq_ = static_cast<T>(rq_ - lq_);
+                depth_ -= static_cast<int>(j) + 1;
+            }
+            return *this;
+        }
+
+        TCB_CONSTEXPR14 iterator operator++(int)
+        {
+            iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend constexpr bool operator==(const iterator& lhs, const iterator& rhs)
+        {
+            return lhs.at_end_ || rhs.at_end_
+                       ? lhs.at_end_ == rhs.at_end_
+                       : lhs.lp_ == rhs.lp_ && lhs.lq_ == rhs.lq_ &&
+                         lhs.rp_ == rhs.rp_ && lhs.rq_ == rhs.rq_;
+        }
+
+        friend constexpr bool operator!=(const iterator& lhs, const iterator& rhs)
+        {
+            return !(lhs == rhs);
+        }
+
+    private:
+        T lp_ = 0;
+        T lq_ = 1;
+        T rp_ = 1;
+        T rq_ = 0;
+        int depth_ = 0;
+        int max_depth_ = 0;
+        bool at_end_ = true;
+    };
+
+    constexpr stern_brocot_view() = default;
+
+    constexpr explicit stern_brocot_view(int max_depth) : max_depth_(max_depth) {}
+
+    constexpr iterator begin() const { return iterator{max_depth_}; }
+
+    constexpr iterator end() const { return iterator{}; }
+
+    // 2^(depth + 1) - 1 nodes
+    constexpr std::size_t size() const
+    {
+        return max_depth_ < 0 ? 0 : (std::size_t{2} << max_depth_) - 1;
+    }
+
+private:
+    int max_depth_ = -1;
+};
+
+template <typename T>
+constexpr stern_brocot_view<T> stern_brocot_sequence(int max_depth)
+{
+    return stern_brocot_view<T>{max_depth};
+}
+
+} // end namespace tcb
+
+#ifdef TCB_HAVE_RANGES
+namespace std {
+namespace ranges {
+
+template <typename T>
+inline constexpr bool enable_borrowed_range<tcb::farey_sequence_view<T>> = true;
+
+template <typename T>
+inline constexpr bool enable_borrowed_range<tcb::calkin_wilf_view<T>> = true;
+
+template <typename T>
+inline constexpr bool enable_borrowed_range<tcb::stern_brocot_view<T>> = true;
+
+} // end namespace ranges
+} // end namespace std
+#endif
+
+#undef TCB_CONSTEXPR14
+
+#endif // TCB_RATIONAL_SEQUENCES_HPP_INCLUDED
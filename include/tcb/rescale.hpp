@@ -0,0 +1,176 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_RESCALE_HPP_INCLUDED
+#define TCB_RESCALE_HPP_INCLUDED
+
+#include <tcb/rational.hpp>
+
+#include <iterator>
+
+#ifdef TCB_HAVE_CONSTEXPR14
+#define TCB_CONSTEXPR14 constexpr
+#else
+#define TCB_CONSTEXPR14
+#endif
+
+namespace tcb {
+
+namespace detail {
+
+template <typename T>
+using unsigned_word_t = std::conditional_t<(sizeof(T) <= sizeof(std::uint32_t)),
+                                           std::uint32_t, std::uint64_t>;
+
+template <typename T>
+constexpr std::make_unsigned_t<T> magnitude(T val)
+{
+    using unsigned_type = std::make_unsigned_t<T>;
+    // Negate in the unsigned type, so that the minimum value is handled
+    return val < 0 ? static_cast<unsigned_type>(0u - static_cast<unsigned_type>(val))
+                   : static_cast<unsigned_type>(val);
+}
+
+template <typename T, typename W>
+constexpr T apply_sign(W mag, bool negative)
+{
+    return static_cast<T>(negative ? static_cast<W>(0u - mag) : mag);
+}
+
+// The factor by which rescale() multiplies, reduced, as a pair of
+// magnitudes and a sign
+template <typename W>
+struct rescale_factor {
+    W num;
+    W denom;
+    bool negative;
+};
+
+template <typename W, typename U, typename V>
+TCB_CONSTEXPR14 rescale_factor<W> make_rescale_factor(const rational<U>& from,
+                                                      const rational<V>& to)
+{
+    // from/to == (a/b) / (c/d) == (a*d) / (b*c), cross-cancelling first so
+    // that the products are as small as possible. Denominators are always
+    // positive, so only the numerators carry a sign.
+    const W a = static_cast<W>(magnitude(from.num()));
+    const W b = static_cast<W>(magnitude(from.denom()));
+    const W c = static_cast<W>(magnitude(to.num()));
+    const W d = static_cast<W>(magnitude(to.denom()));
+    const W g1 = gcd(a, c);
+    const W g2 = gcd(d, b);
+    return {static_cast<W>((a / g1) * (d / g2)),
+            static_cast<W>((b / g2) * (c / g1)),
+            (from.num() < 0) != (to.num() < 0)};
+}
+
+template <rounding Mode, typename InputIt, typename OutputIt, typename W>
+OutputIt rescale_batch(InputIt first, InputIt last, OutputIt out,
+                       const rescale_factor<W>& factor,
+                       const invariant_divider<W>& divider)
+{
+    using value_type = typename std::iterator_traits<InputIt>::value_type;
+
+    if (factor.denom == 1) {
+        for (; first != last; ++first, ++out) {
+            const value_type x = *first;
+            const W mag = static_cast<W>(magnitude(x) * factor.num);
+            *out = apply_sign<value_type>(mag, (x < 0) != factor.negative);
+        }
+        return out;
+    }
+
+    for (; first != last; ++first, ++out) {
+        const value_type x = *first;
+        const bool negative = (x < 0) != factor.negative;
+        const double_word<W> p = mul_wide(static_cast<W>(magnitude(x)), factor.num);
+        W rem = 0;
+        const W q = divider.divide(p.hi, p.lo, rem);
+        *out = apply_sign<value_type>(round_quotient(q, rem, factor.denom, negative, Mode),
+                                      negative);
+    }
+    return out;
+}
+
+template <typename InputIt, typename OutputIt, typename W>
+OutputIt rescale_batch(InputIt first, InputIt last, OutputIt out,
+                       const rescale_factor<W>& factor,
+                       const invariant_divider<W>& divider, rounding mode)
+{
+    // Select the rounding mode once, outside the loop
+    switch (mode) {
+    case rounding::toward_zero:
+        return rescale_batch<rounding::toward_zero>(first, last, out, factor, divider);
+    case rounding::away_from_zero:
+        return rescale_batch<rounding::away_from_zero>(first, last, out, factor, divider);
+    case rounding::down:
+        return rescale_batch<rounding::down>(first, last, out, factor, divider);
+    case rounding::up:
+        return rescale_batch<rounding::up>(first, last, out, factor, divider);
+    case rounding::nearest:
+        break;
+    }
+    return rescale_batch<rounding::nearest>(first, last, out, factor, divider);
+}
+
+} // end namespace detail
+
+/*
+ * Converts value, counted in units of from, into units of to: that is,
+ * computes value * from / to, rounding as requested. This is the usual
+ * operation for converting timestamps between timebases.
+ *
+ * The product is formed exactly using double-width arithmetic. After
+ * cancellation, the numerator and denominator of from/to must fit in
+ * T's width (which is always true if the rationals are no wider than
+ * half of T), and the result must be representable in T.
+ */
+template <typename T, typename U, typename V,
+          typename = std::enable_if_t<std::is_integral<T>::value>>
+TCB_CONSTEXPR14 T rescale(T value, const rational<U>& from, const rational<V>& to,
+                          rounding mode = rounding::toward_zero)
+{
+    static_assert(sizeof(T) <= sizeof(std::uint64_t),
+                  "tcb::rescale() supports integers of up to 64 bits");
+    using word_type = detail::unsigned_word_t<T>;
+
+    const auto factor = detail::make_rescale_factor<word_type>(from, to);
+    const bool negative = (value < 0) != factor.negative;
+    const auto p = detail::mul_wide(static_cast<word_type>(detail::magnitude(value)),
+                                    factor.num);
+    word_type rem = 0;
+    const word_type q = detail::div_wide(p.hi, p.lo, factor.denom, rem);
+    return detail::apply_sign<T>(
+            detail::round_quotient(q, rem, factor.denom, negative, mode), negative);
+}
+
+/*
+ * Rescales each value in [first, last), writing the results to out. The
+ * factor is reduced once, and the per-element division is replaced by
+ * multiplication with a precomputed reciprocal of its denominator.
+ * Returns an iterator past the last element written.
+ */
+template <typename InputIt, typename OutputIt, typename U, typename V>
+OutputIt rescale(InputIt first, InputIt last, OutputIt out,
+                 const rational<U>& from, const rational<V>& to,
+                 rounding mode = rounding::toward_zero)
+{
+    using value_type = typename std::iterator_traits<InputIt>::value_type;
+    static_assert(std::is_integral<value_type>::value &&
+                  sizeof(value_type) <= sizeof(std::uint64_t),
+                  "tcb::rescale() supports integers of up to 64 bits");
+    using word_type = detail::unsigned_word_t<value_type>;
+
+    const auto factor = detail::make_rescale_factor<word_type>(from, to);
+    return detail::rescale_batch(first, last, out, factor,
+                                 detail::invariant_divider<word_type>(factor.denom),
+                                 mode);
+}
+
+} // end namespace tcb
+
+#undef TCB_CONSTEXPR14
+
+#endif // TCB_RESCALE_HPP_INCLUDED
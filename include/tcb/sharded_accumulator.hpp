@@ -0,0 +1,289 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TCB_SHARDED_ACCUMULATOR_HPP_INCLUDED
+#define TCB_SHARDED_ACCUMULATOR_HPP_INCLUDED
+
+#include <tcb/big_rational.hpp>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+namespace tcb {
+
+namespace detail {
+
+// Assumed size of a cache line, used to keep shards apart
+constexpr std::size_t cache_line_size = 64;
+
+// A small index, unique to the calling thread, used to pick a shard
+inline std::size_t thread_slot()
+{
+    static std::atomic<std::size_t> next_slot{0};
+    thread_local const std::size_t slot = next_slot.fetch_add(1, std::memory_order_relaxed);
+    return slot;
+}
+
+// Tells the processor that the caller is spinning on a lock, which saves
+// power and frees execution resources for a sibling hyperthread
+inline void spin_pause()
+{
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_ia32_pause();
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+// The number of pauses a waiting thread spins for before yielding its time
+// slice, long enough to cover a typical add
+constexpr int spin_limit = 64;
+
+// a + b and a * b, returning false on overflow
+template <typename T>
+bool checked_add(T a, T b, T& result)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return !__builtin_add_overflow(a, b, &result);
+#else
+    if ((b > 0 && a > std::numeric_limits<T>::max() - b) ||
+        (b < 0 && a < std::numeric_limits<T>::min() - b)) {
+        return false;
+    }
+    result = static_cast<T>(a + b);
+    return true;
+#endif
+}
+
+template <typename T>
+bool checked_mul(T a, T b, T& result)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return !__builtin_mul_overflow(a, b, &result);
+#else
+    if (a != 0 && b != 0) {
+        const T lim = ((a < 0) != (b < 0)) ? std::numeric_limits<T>::min()
+                                           : std::numeric_limits<T>::max();
+        // The quotient of the limit by a is the largest |b| which fits
+        if ((a < 0) == (b < 0) ? (a > 0 ? b > lim / a : b < lim / a)
+                               : (a > 0 ? b < lim / a : b > lim / a)) {
+            return false;
+        }
+    }
+    result = static_cast<T>(a * b);
+    return true;
+#endif
+}
+
+// The type in which a shard sums rational<T>: twice as wide as T, using
+// 128-bit integers for 64-bit T where they are available
+#ifdef TCB_RATIONAL_HAVE_INT128
+template <typename T>
+using shard_wide_t = std::conditional_t<(sizeof(T) < sizeof(std::int64_t)),
+                                        next_wider_t<T>, int128_t>;
+
+inline big_integer to_big_integer(int128_t value)
+{
+    const bool negative = value < 0;
+    const auto mag = negative ? uint128_t{0} - static_cast<uint128_t>(value)
+                              : static_cast<uint128_t>(value);
+    const big_integer word_base = big_integer{std::uint64_t{1} << 32} * big_integer{std::uint64_t{1} << 32};
+    const big_integer result = big_integer{static_cast<std::uint64_t>(mag >> 64)} * word_base +
+                               big_integer{static_cast<std::uint64_t>(mag)};
+    return negative ? -result : result;
+}
+#else
+template <typename T>
+using shard_wide_t = next_wider_t<T>;
+#endif
+
+template <typename W>
+big_integer to_big_integer(W value)
+{
+    return big_integer{value};
+}
+
+} // end namespace detail
+
+template <typename T>
+class sharded_accumulator;
+
+/*
+ * An exact running total of rationals, added to concurrently from many
+ * threads.
+ *
+ * Threads are assigned to shards in turn, and each shard is padded to keep
+ * it on a separate cache line from its neighbours, so adds do not contend
+ * as long as there are no more threads than shards (by default, one per
+ * hardware thread). Threads which share a shard take turns under a lock
+ * that spins briefly and then yields; pass more shards to the constructor
+ * if many more threads than cores will add at once.
+ *
+ * Within a shard, the sum is held unnormalized in a type twice as wide as
+ * T, and is only reduced when the next addition would otherwise overflow;
+ * equal denominators are summed with a single integer addition. If a
+ * shard's sum cannot be held even after reducing, it is moved into an
+ * arbitrary-precision overflow total.
+ *
+ * total() merges the shards exactly, using big_rational intermediates, so
+ * the result is correct however large the partial sums become. Merging
+ * while other threads are adding is safe, but the result may or may not
+ * include the concurrent additions.
+ */
+template <typename T>
+class sharded_accumulator<rational<T>> {
+public:
+    using value_type = rational<T>;
+
+    // By default, one shard per hardware thread
+    explicit sharded_accumulator(std::size_t num_shards = std::thread::hardware_concurrency())
+        : num_shards_(num_shards > 0 ? num_shards : 1),
+          shards_(new shard[num_shards_])
+    {}
+
+    sharded_accumulator(const sharded_accumulator&) = delete;
+
+    sharded_accumulator& operator=(const sharded_accumulator&) = delete;
+
+    std::size_t num_shards() const { return num_shards_; }
+
+    void add(const value_type& value)
+    {
+        shard& s = shards_[detail::thread_slot() % num_shards_];
+        lock_guard guard{s};
+        s.add(value);
+    }
+
+    sharded_accumulator& operator+=(const value_type& value)
+    {
+        add(value);
+        return *this;
+    }
+
+    // The exact sum of all values added so far
+    big_rational exact_total() const
+    {
+        big_rational total;
+        for (std::size_t i = 0; i < num_shards_; ++i) {
+            shard& s = shards_[i];
+            lock_guard guard{s};
+            total += s.overflow;
+            total += big_rational{detail::to_big_integer(s.num), detail::to_big_integer(s.denom)};
+        }
+        return total;
+    }
+
+    // Precondition: the exact sum is representable as a rational<T>
+    value_type total() const
+    {
+        return static_cast<value_type>(exact_total());
+    }
+
+    void reset()
+    {
+        for (std::size_t i = 0; i < num_shards_; ++i) {
+            shard& s = shards_[i];
+            lock_guard guard{s};
+            s.num = 0;
+            s.denom = 1;
+            s.overflow = big_rational{};
+        }
+    }
+
+private:
+    using wide_type = detail::shard_wide_t<T>;
+
+    struct shard {
+        // Keeps the hot members of adjacent shards on different cache lines
+        // without relying on over-aligned allocation
+        char leading_pad[detail::cache_line_size];
+
+        // Held by the owning thread while adding. It is only contended if
+        // there are more threads than shards, or during a merge.
+        std::atomic<bool> locked{false};
+        wide_type num = 0;
+        wide_type denom = 1;
+        big_rational overflow;
+
+        void add(const value_type& value)
+        {
+            const wide_type a = value.num();
+            const wide_type b = value.denom();
+            if (try_add(a, b)) {
+                return;
+            }
+            // Reduce and retry, then spill into the overflow total
+            const wide_type g = detail::abs(detail::gcd(num, denom));
+            num /= g;
+            denom /= g;
+            if (try_add(a, b)) {
+                return;
+            }
+            overflow += big_rational{detail::to_big_integer(num), detail::to_big_integer(denom)};
+            num = a;
+            denom = b;
+        }
+
+        bool try_add(wide_type a, wide_type b)
+        {
+            if (b == denom) {
+                wide_type sum = 0;
+                if (!detail::checked_add(num, a, sum)) {
+                    return false;
+                }
+                num = sum;
+                return true;
+            }
+            wide_type lhs = 0;
+            wide_type rhs = 0;
+            wide_type new_num = 0;
+            wide_type new_denom = 0;
+            if (!detail::checked_mul(num, b, lhs) ||
+                !detail::checked_mul(a, denom, rhs) ||
+                !detail::checked_add(lhs, rhs, new_num) ||
+                !detail::checked_mul(denom, b, new_denom)) {
+                return false;
+            }
+            num = new_num;
+            denom = new_denom;
+            return true;
+        }
+    };
+
+    struct lock_guard {
+        explicit lock_guard(shard& s) : s_(s)
+        {
+            int spins = 0;
+            while (s_.locked.exchange(true, std::memory_order_acquire)) {
+                while (s_.locked.load(std::memory_order_relaxed)) {
+                    // Spin briefly, as the holder is usually about to
+                    // release the lock, then let other threads run
+                    if (spins < detail::spin_limit) {
+                        detail::spin_pause();
+                        ++spins;
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+        }
+
+        ~lock_guard() { s_.locked.store(false, std::memory_order_release); }
+
+        lock_guard(const lock_guard&) = delete;
+        lock_guard& operator=(const lock_guard&) = delete;
+
+    private:
+        shard& s_;
+    };
+
+    std::size_t num_shards_;
+    std::unique_ptr<shard[]> shards_;
+};
+
+} // end namespace tcb
+
+#endif // TCB_SHARDED_ACCUMULATOR_HPP_INCLUDED
@@ -0,0 +1,107 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "catch.hpp"
+
+#include <tcb/atomic_rational.hpp>
+
+#include <thread>
+#include <vector>
+
+namespace {
+
+template <typename T>
+void test_atomic_operations()
+{
+    using rational = tcb::rational<T>;
+
+    tcb::atomic_rational<T> a;
+    REQUIRE(a.load() == 0);
+
+    a.store(rational{1, 2});
+    REQUIRE(a.load() == rational(1, 2));
+
+    REQUIRE(a.fetch_add(rational{1, 3}) == rational(1, 2));
+    REQUIRE(a.load() == rational(5, 6));
+
+    REQUIRE(a.fetch_sub(rational{1, 6}) == rational(5, 6));
+    REQUIRE(a.load() == rational(2, 3));
+
+    REQUIRE(a.fetch_mul(rational{9, 4}) == rational(2, 3));
+    REQUIRE(a.load() == rational(3, 2));
+
+    REQUIRE(a.fetch_div(rational{3, 7}) == rational(3, 2));
+    REQUIRE(a.load() == rational(7, 2));
+
+    REQUIRE((a += rational{1, 2}) == 4);
+    REQUIRE((a -= 1) == 3);
+    REQUIRE((a *= rational{1, 6}) == rational(1, 2));
+    REQUIRE((a /= rational{1, 4}) == 2);
+
+    REQUIRE(a.exchange(rational{5, 3}) == 2);
+
+    rational expected{1, 1};
+    REQUIRE_FALSE(a.compare_exchange_strong(expected, rational{2, 3}));
+    REQUIRE(expected == rational(5, 3));
+    REQUIRE(a.compare_exchange_strong(expected, rational{2, 3}));
+    REQUIRE(static_cast<rational>(a) == rational(2, 3));
+
+    // Equal values compare equal bitwise, as they are always canonical
+    expected = rational{4, 6};
+    REQUIRE(a.compare_exchange_strong(expected, rational{-1, 3}));
+    REQUIRE(a.load() == rational(-1, 3));
+}
+
+template <typename T>
+void test_concurrent_updates()
+{
+    using rational = tcb::rational<T>;
+    constexpr int num_threads = 4;
+    constexpr int iterations = 2000;
+
+    tcb::atomic_rational<T> sum;
+    tcb::atomic_rational<T> product{rational{1}};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&sum, &product, t] {
+            for (int i = 0; i < iterations; ++i) {
+                sum.fetch_add(rational{1, 4}, std::memory_order_relaxed);
+                // Alternately multiply by (t + 2) and divide it back out
+                if (i % 2 == 0) {
+                    product *= rational{t + 2, 3};
+                } else {
+                    product /= rational{t + 2, 3};
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(sum.load() == rational{num_threads * iterations / 4});
+    REQUIRE(product.load() == 1);
+}
+
+}
+
+TEST_CASE("Atomic rationals support loads, stores and updates")
+{
+    test_atomic_operations<short>();
+    test_atomic_operations<int>();
+    test_atomic_operations<long long>();
+}
+
+TEST_CASE("Narrow atomic rationals are lock-free")
+{
+    REQUIRE(tcb::atomic_rational<std::int16_t>{}.is_lock_free());
+    REQUIRE(tcb::atomic_rational<std::int32_t>{}.is_lock_free());
+}
+
+TEST_CASE("Atomic rationals can be updated concurrently")
+{
+    test_concurrent_updates<int>();
+    test_concurrent_updates<long long>();
+}
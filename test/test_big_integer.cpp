@@ -0,0 +1,126 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "catch.hpp"
+
+#include <tcb/big_rational.hpp>
+
+#include <random>
+#include <sstream>
+
+using tcb::big_integer;
+using tcb::big_rational;
+
+namespace {
+
+// A random value of up to limbs * 32 bits, with a random sign
+big_integer random_big(std::mt19937_64& gen, int limbs)
+{
+    big_integer result;
+    for (int i = 0; i < limbs; ++i) {
+        result = result * big_integer{1ull << 32} + big_integer{static_cast<std::uint32_t>(gen())};
+    }
+    return (gen() & 1) ? -result : result;
+}
+
+}
+
+TEST_CASE("big_integer matches built-in arithmetic")
+{
+    std::mt19937_64 gen{42};
+    std::uniform_int_distribution<long long> dist(-3037000499LL, 3037000499LL);
+    for (int i = 0; i < 2000; ++i) {
+        const long long a = dist(gen);
+        long long b = dist(gen);
+        if (b == 0) {
+            b = 1;
+        }
+        const big_integer ba{a};
+        const big_integer bb{b};
+
+        REQUIRE(static_cast<long long>(ba + bb) == a + b);
+        REQUIRE(static_cast<long long>(ba - bb) == a - b);
+        REQUIRE(static_cast<long long>(ba * bb) == a * b);
+        REQUIRE(static_cast<long long>(ba / bb) == a / b);
+        REQUIRE(static_cast<long long>(ba % bb) == a % b);
+        REQUIRE((ba < bb) == (a < b));
+        REQUIRE((ba == bb) == (a == b));
+    }
+}
+
+TEST_CASE("big_integer division is exact for multi-limb values")
+{
+    std::mt19937_64 gen{7};
+    for (int i = 0; i < 500; ++i) {
+        const big_integer a = random_big(gen, 1 + static_cast<int>(gen() % 6));
+        big_integer b = random_big(gen, 1 + static_cast<int>(gen() % 4));
+        if (b.is_zero()) {
+            b = 3;
+        }
+        big_integer rem;
+        const big_integer quot = big_integer::divide(a, b, rem);
+        REQUIRE(quot * b + rem == a);
+        REQUIRE(tcb::abs(rem) < tcb::abs(b));
+        REQUIRE((rem.is_zero() || rem.is_negative() == a.is_negative()));
+    }
+
+    // A divisor whose top limb needs no normalizing shift
+    const big_integer u = big_integer{1} * big_integer{0x7fffffffffffffffLL} *
+                          big_integer{0x100000000LL};
+    const big_integer v = big_integer{0x7fffffffffffffffLL} + big_integer{1};
+    REQUIRE(u / v * v + u % v == u);
+}
+
+TEST_CASE("big_integer conversions")
+{
+    REQUIRE(big_integer{}.is_zero());
+    REQUIRE(big_integer{-0}.signum() == 0);
+    REQUIRE(big_integer{std::numeric_limits<long long>::min()}.fits<long long>());
+    REQUIRE_FALSE((-big_integer{std::numeric_limits<long long>::min()}).fits<long long>());
+    REQUIRE(big_integer{255}.fits<unsigned char>());
+    REQUIRE_FALSE(big_integer{256}.fits<unsigned char>());
+    REQUIRE_FALSE(big_integer{-1}.fits<unsigned>());
+    REQUIRE(static_cast<long long>(big_integer{std::numeric_limits<long long>::min()}) ==
+            std::numeric_limits<long long>::min());
+
+    const big_integer big = big_integer{1000000000000LL} * big_integer{1000000000000LL};
+    REQUIRE(big.to_string() == "1000000000000000000000000");
+    REQUIRE((-big - 7).to_string() == "-1000000000000000000000007");
+    REQUIRE(big.bit_width() == 80);
+    REQUIRE_FALSE(big.fits<unsigned long long>());
+
+    std::ostringstream ss;
+    ss << big_integer{-1234567890123LL};
+    REQUIRE(ss.str() == "-1234567890123");
+
+    REQUIRE(tcb::gcd(big_integer{-84}, big_integer{36}) == 12);
+}
+
+TEST_CASE("big_rational arithmetic is exact")
+{
+    const big_rational a{tcb::rational<int>{1, 3}};
+    const big_rational b{tcb::rational<int>{-5, 6}};
+    REQUIRE(a + b == big_rational(-1, 2));
+    REQUIRE(a - b == big_rational(7, 6));
+    REQUIRE(a * b == big_rational(-5, 18));
+    REQUIRE(a / b == big_rational(-2, 5));
+    REQUIRE(b < a);
+    REQUIRE(big_rational(6, -4).num() == -3);
+    REQUIRE(big_rational(6, -4).denom() == 2);
+
+    // Sums which overflow every built-in type
+    big_rational sum;
+    for (long long d = 1; d <= 60; ++d) {
+        sum += big_rational{tcb::rational<long long>{1, d}};
+    }
+    REQUIRE_FALSE(sum.fits<long long>());
+    sum -= sum - big_rational{3, 7};
+    REQUIRE(sum.fits<int>());
+    REQUIRE(static_cast<tcb::rational<int>>(sum) == tcb::rational<int>(3, 7));
+
+    std::ostringstream ss;
+    ss << big_rational{-3, 7} << ' ' << big_rational{4};
+    REQUIRE(ss.str() == "-3/7 4");
+}
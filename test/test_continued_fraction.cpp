@@ -0,0 +1,151 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "catch.hpp"
+
+#include <tcb/continued_fraction.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+template <typename Range>
+auto to_vector(const Range& range)
+{
+    std::vector<std::decay_t<decltype(*range.begin())>> result;
+    for (const auto& elem : range) {
+        result.push_back(elem);
+    }
+    return result;
+}
+
+using r64 = tcb::rational<long long>;
+
+// Evaluates [terms[0]; terms[1], ...] from the back
+r64 evaluate(const std::vector<long long>& terms)
+{
+    r64 value{terms.back()};
+    for (auto it = terms.rbegin() + 1; it != terms.rend(); ++it) {
+        value = *it + tcb::reciprocal(value);
+    }
+    return value;
+}
+
+constexpr int count_convergents(tcb::rational<int> r, int max_denom)
+{
+    int count = 0;
+    for (const auto c : tcb::views::convergents(r, max_denom)) {
+        (void) c;
+        ++count;
+    }
+    return count;
+}
+
+}
+
+TEST_CASE("Continued fraction terms")
+{
+    using v = std::vector<int>;
+    const auto terms = [](int num, int denom) {
+        return to_vector(tcb::views::continued_fraction(tcb::rational<int>(num, denom)));
+    };
+    REQUIRE(terms(415, 93) == (v{4, 2, 6, 7}));
+    REQUIRE(terms(-415, 93) == (v{-5, 1, 1, 6, 7}));
+    REQUIRE(terms(1, 2) == (v{0, 2}));
+    REQUIRE(terms(3, 1) == v{3});
+    REQUIRE(terms(0, 1) == v{0});
+    const auto view = tcb::views::continued_fraction(tcb::rational<int>(415, 93));
+    auto it = view.begin();
+    REQUIRE(*it++ == 4);
+    REQUIRE(*it == 2);
+    REQUIRE(it != view.end());
+    REQUIRE(it == std::next(view.begin()));
+    REQUIRE(std::distance(view.begin(), view.end()) == 4);
+}
+
+TEST_CASE("Convergents")
+{
+    using v = std::vector<tcb::rational<int>>;
+    const tcb::rational<int> r{415, 93};
+    REQUIRE(to_vector(tcb::views::convergents(r)) ==
+            (v{{4, 1}, {9, 2}, {58, 13}, {415, 93}}));
+    REQUIRE(to_vector(tcb::views::convergents(r, 20)) == (v{{4, 1}, {9, 2}, {58, 13}}));
+    REQUIRE(to_vector(tcb::views::convergents(r, 13)) == (v{{4, 1}, {9, 2}, {58, 13}}));
+    REQUIRE(to_vector(tcb::views::convergents(r, 1)) == v{4});
+    REQUIRE(to_vector(tcb::views::convergents(r, 0)).empty());
+    REQUIRE(to_vector(tcb::views::convergents(-r)) ==
+            (v{{-5, 1}, {-4, 1}, {-9, 2}, {-58, 13}, {-415, 93}}));
+
+    // Best approximations of pi with small denominators
+    const tcb::rational64_t pi{3141592653589793, 1000000000000000};
+    REQUIRE(to_vector(tcb::views::convergents(pi, std::int64_t{200})).back() == r64(355, 113));
+    REQUIRE(to_vector(tcb::views::convergents(pi)).back() == pi);
+
+    static_assert(count_convergents({415, 93}, 1000) == 4, "");
+    static_assert(count_convergents({415, 93}, 10) == 2, "");
+}
+
+TEST_CASE("Semiconvergents")
+{
+    using v = std::vector<tcb::rational<int>>;
+    const tcb::rational<int> r{415, 93};
+    REQUIRE(to_vector(tcb::views::semiconvergents(r, 13)) ==
+            (v{{4, 1}, {5, 1}, {9, 2}, {13, 3}, {22, 5}, {31, 7}, {40, 9}, {49, 11}, {58, 13}}));
+
+    const auto all = to_vector(tcb::views::semiconvergents(r));
+    REQUIRE(all.size() == 16);
+    REQUIRE(all[9] == r64(67, 15));
+    REQUIRE(all.back() == r);
+
+    REQUIRE(to_vector(tcb::views::semiconvergents(tcb::rational<int>{2})) == v{2});
+}
+
+TEST_CASE("Continued fractions of every rational8_t")
+{
+    using T = std::int_least8_t;
+    const T max = std::numeric_limits<T>::max();
+    for (int n = std::numeric_limits<T>::min(); n <= max; ++n) {
+        for (int d = 1; d <= max; ++d) {
+            const tcb::rational8_t r{static_cast<T>(n), static_cast<T>(d)};
+
+            std::vector<long long> terms;
+            for (const T term : tcb::views::continued_fraction(r)) {
+                REQUIRE((terms.empty() || term > 0));
+                terms.push_back(term);
+            }
+            REQUIRE((terms.size() == 1 || terms.back() >= 2));
+            REQUIRE(evaluate(terms) == r64(r.num(), r.denom()));
+
+            // The convergents are those of the terms, each closer to r than
+            // the last
+            std::vector<long long> prefix;
+            r64 last_error{-1};
+            tcb::rational8_t last{};
+            for (const auto c : tcb::views::convergents(r)) {
+                prefix.push_back(terms.at(prefix.size()));
+                REQUIRE(r64(c.num(), c.denom()) == evaluate(prefix));
+                const r64 diff = r64(c.num(), c.denom()) - r64(r.num(), r.denom());
+                const r64 error = diff < 0 ? -diff : diff;
+                REQUIRE((last_error < 0 || error < last_error));
+                last_error = error;
+                last = c;
+            }
+            REQUIRE(prefix.size() == terms.size());
+            REQUIRE(last == r);
+
+            // Semiconvergents have non-decreasing denominators, and include
+            // every convergent
+            std::size_t semis = 0;
+            T last_denom = 0;
+            for (const auto s : tcb::views::semiconvergents(r)) {
+                REQUIRE(s.denom() >= last_denom);
+                last_denom = s.denom();
+                ++semis;
+            }
+            REQUIRE(semis >= terms.size());
+        }
+    }
+}
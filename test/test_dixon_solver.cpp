@@ -0,0 +1,163 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "catch.hpp"
+
+#include <tcb/dixon_solver.hpp>
+
+#include <random>
+#include <vector>
+
+namespace {
+
+using tcb::big_rational;
+
+// Solves a x = b by Gaussian elimination over the rationals, returning
+// false if the matrix is singular
+template <typename I>
+bool reference_solve(const std::vector<I>& a, const std::vector<I>& b,
+                     std::vector<big_rational>& x)
+{
+    const std::size_t n = b.size();
+    std::vector<std::vector<big_rational>> m(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            m[i].emplace_back(a[i * n + j]);
+        }
+        m[i].emplace_back(b[i]);
+    }
+    for (std::size_t col = 0; col < n; ++col) {
+        std::size_t pivot = col;
+        while (pivot < n && m[pivot][col] == big_rational{}) {
+            ++pivot;
+        }
+        if (pivot == n) {
+            return false;
+        }
+        std::swap(m[col], m[pivot]);
+        for (std::size_t row = col + 1; row < n; ++row) {
+            const big_rational factor = m[row][col] / m[col][col];
+            for (std::size_t k = col; k <= n; ++k) {
+                m[row][k] -= factor * m[col][k];
+            }
+        }
+    }
+    x.assign(n, big_rational{});
+    for (std::size_t i = n; i-- > 0;) {
+        big_rational sum = m[i][n];
+        for (std::size_t j = i + 1; j < n; ++j) {
+            sum -= m[i][j] * x[j];
+        }
+        x[i] = sum / m[i][i];
+    }
+    return true;
+}
+
+template <typename I>
+std::vector<I> random_vector(std::size_t size, I lo, I hi, std::mt19937_64& gen)
+{
+    std::uniform_int_distribution<I> dist{lo, hi};
+    std::vector<I> result(size);
+    for (auto& elem : result) {
+        elem = dist(gen);
+    }
+    return result;
+}
+
+}
+
+TEST_CASE("Dixon solver agrees with elimination")
+{
+    std::mt19937_64 gen{49};
+    for (std::size_t n = 1; n <= 10; ++n) {
+        for (const long long range : {1LL, 9LL, 1000000LL, std::numeric_limits<long long>::max()}) {
+            const auto a = random_vector<long long>(n * n, -range, range, gen);
+            const auto b = random_vector<long long>(n, -range, range, gen);
+            std::vector<big_rational> expected, result;
+            const bool solvable = reference_solve(a, b, expected);
+            REQUIRE(tcb::dixon_solve(a, b, result) == solvable);
+            if (solvable) {
+                REQUIRE(result == expected);
+            }
+        }
+    }
+
+    // Narrow coefficient types
+    const std::vector<signed char> a{-128, 127, 5, 3};
+    const std::vector<signed char> b{1, -1};
+    std::vector<big_rational> expected, result;
+    REQUIRE(reference_solve(a, b, expected));
+    REQUIRE(tcb::dixon_solve(a, b, result));
+    REQUIRE(result == expected);
+}
+
+TEST_CASE("Dixon solver special cases")
+{
+    std::vector<big_rational> result;
+
+    // Empty and zero right-hand sides
+    REQUIRE(tcb::dixon_solve(std::vector<int>{}, std::vector<int>{}, result));
+    REQUIRE(result.empty());
+    REQUIRE(tcb::dixon_solve(std::vector<int>{2, 1, 1, 3}, std::vector<int>{0, 0}, result));
+    REQUIRE(result == std::vector<big_rational>(2));
+
+    // Singular matrices
+    REQUIRE_FALSE(tcb::dixon_solve(std::vector<int>{1, 2, 2, 4}, std::vector<int>{1, 1}, result));
+    REQUIRE_FALSE(tcb::dixon_solve(std::vector<int>{0, 1, 0, 1}, std::vector<int>{1, 1}, result));
+
+    // A determinant divisible by the first prime needs another
+    const long long p = (1LL << 62) - 57;
+    REQUIRE(tcb::dixon_solve(std::vector<long long>{p, 0, 0, 1}, std::vector<long long>{1, 2}, result));
+    REQUIRE(result == (std::vector<big_rational>{{1, p}, 2}));
+
+    // The Hilbert-like matrix 1 / (i + j + 1), scaled to integers, has a
+    // notoriously large inverse
+    const std::size_t n = 10;
+    std::vector<long long> hilbert(n * n);
+    const long long scale = 2329089562800LL;  // lcm(1, ..., 20)
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            hilbert[i * n + j] = scale / static_cast<long long>(i + j + 1);
+        }
+    }
+    const std::vector<long long> ones(n, 1);
+    std::vector<big_rational> expected;
+    REQUIRE(reference_solve(hilbert, ones, expected));
+    REQUIRE(tcb::dixon_solve(hilbert, ones, result));
+    REQUIRE(result == expected);
+}
+
+TEST_CASE("Dixon solver with fixed-width results")
+{
+    const std::vector<int> a{2, 1, 1, 3};
+    std::vector<tcb::rational_max_t> result;
+    REQUIRE(tcb::dixon_solve(a, std::vector<int>{1, 2}, result));
+    REQUIRE(result == (std::vector<tcb::rational_max_t>{{1, 5}, {3, 5}}));
+
+    // 2^40 / 3 fits in rational_max_t but not rational32_t
+    std::vector<tcb::rational32_t> narrow;
+    const std::vector<long long> big{3, 0, 0, 1};
+    REQUIRE_FALSE(tcb::dixon_solve(big, std::vector<long long>{1LL << 40, 1}, narrow));
+    REQUIRE(tcb::dixon_solve(big, std::vector<long long>{1LL << 40, 1}, result));
+    REQUIRE(result[0] == tcb::rational_max_t(1LL << 40, 3));
+}
+
+TEST_CASE("Dixon solver on larger systems")
+{
+    // Too slow to compare with elimination, so check the residual instead
+    std::mt19937_64 gen{4900};
+    const std::size_t n = 30;
+    const auto a = random_vector<int>(n * n, -99, 99, gen);
+    const auto b = random_vector<int>(n, -99, 99, gen);
+    std::vector<big_rational> result;
+    REQUIRE(tcb::dixon_solve(a, b, result));
+    for (std::size_t i = 0; i < n; ++i) {
+        big_rational sum;
+        for (std::size_t j = 0; j < n; ++j) {
+            sum += big_rational{a[i * n + j]} * result[j];
+        }
+        REQUIRE(sum == big_rational{b[i]});
+    }
+}
@@ -0,0 +1,139 @@
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "catch.hpp"
+
+#include <tcb/fixed_denom_rational.hpp>
+
+#include <random>
+#include <sstream>
+
+namespace {
+
+using timestamp = tcb::fixed_denom_rational<std::int64_t, 90000>;
+using price = tcb::fixed_denom_rational<std::int32_t, 100>;
+
+template <std::int64_t C>
+bool agrees_with_division(std::int64_t a, std::int64_t b)
+{
+    return tcb::detail::fixed_mul_div_by<std::int64_t, C>(a, b) ==
+           tcb::detail::fixed_mul_div<std::int64_t>(a, b, C);
+}
+
+}
+
+TEST_CASE("Fixed-denominator rationals can be constructed")
+{
+    static_assert(sizeof(timestamp) == sizeof(std::int64_t), "");
+
+    constexpr timestamp t1{};
+    static_assert(t1.num() == 0, "");
+    static_assert(timestamp::denom() == 90000, "");
+
+    constexpr timestamp t2 = 3;
+    static_assert(t2.num() == 270000, "");
+
+    constexpr timestamp t3 = std::milli{};
+    static_assert(t3.num() == 90, "");
+
+    const timestamp t4{tcb::rational<int>{1, 3}};
+    REQUIRE(t4.num() == 30000);
+
+    // Inexact values are truncated towards zero
+    const price p1{tcb::rational<int>{1, 3}};
+    REQUIRE(p1.num() == 33);
+    const price p2{tcb::rational<int>{-1, 3}};
+    REQUIRE(p2.num() == -33);
+
+    REQUIRE(timestamp::from_num(45000).num() == 45000);
+}
+
+TEST_CASE("Fixed-denominator rationals convert to rational")
+{
+    const tcb::rational<std::int64_t> r = timestamp::from_num(45000);
+    REQUIRE(r.num() == 1);
+    REQUIRE(r.denom() == 2);
+
+    REQUIRE(static_cast<long double>(price::from_num(125)) == 1.25);
+
+    static_assert(std::is_same<timestamp::period, std::ratio<1, 90000>>::value, "");
+}
+
+TEST_CASE("Fixed-denominator arithmetic works as expected")
+{
+    const price a = price::from_num(150);  // 1.50
+    const price b = price::from_num(-25);  // -0.25
+
+    REQUIRE((a + b).num() == 125);
+    REQUIRE((a - b).num() == 175);
+    REQUIRE((-a).num() == -150);
+    REQUIRE((+a).num() == 150);
+    REQUIRE((a * 3).num() == 450);
+    REQUIRE((3 * a).num() == 450);
+    REQUIRE((a / 4).num() == 37);
+
+    // 1.50 * -0.25 = -0.375, truncated
+    REQUIRE((a * b).num() == -37);
+    // 1.50 / -0.25 = -6
+    REQUIRE((a / b).num() == -600);
+
+    price c = a;
+    c += b;
+    c -= price{1};
+    REQUIRE(c.num() == 25);
+}
+
+TEST_CASE("Fixed-denominator arithmetic on large 64-bit values")
+{
+    // The products of the numerators overflow 64 bits, but the results do
+    // not
+    REQUIRE((timestamp(100000) * timestamp(100000)).num() == 900000000000000);
+    REQUIRE((timestamp(-100000) * timestamp(100000)).num() == -900000000000000);
+    REQUIRE((timestamp(1000000000) / timestamp(3)).num() == 30000000000000);
+    REQUIRE((timestamp(-1000000000) / timestamp(-4)).num() == 22500000000000);
+    REQUIRE(timestamp(tcb::rational64_t(1000000000001, 3)).num() == 30000000000030000);
+    REQUIRE(timestamp(tcb::rational64_t(-1000000000001, 3)).num() == -30000000000030000);
+
+    using fine = tcb::fixed_denom_rational<std::int64_t, 100000000>;
+    const fine x = fine::from_num(123456789012);  // 1234.56789012
+    REQUIRE((x * x).num() == 152415787531534);
+    REQUIRE((x * -x).num() == -152415787531534);
+    REQUIRE((x / fine::from_num(7)).num() == 1763668414457142857);
+}
+
+TEST_CASE("Fixed-denominator products divide by a compile-time reciprocal")
+{
+    // Agrees with a run-time double-word division, including for divisors
+    // which are already normalised and for a denominator of one
+    std::mt19937_64 gen{27};
+    std::uniform_int_distribution<std::int64_t> dist{-(std::int64_t{1} << 38), std::int64_t{1} << 38};
+    for (int i = 0; i < 1000; ++i) {
+        const std::int64_t a = dist(gen);
+        const std::int64_t b = dist(gen) >> (i % 20);
+        REQUIRE(agrees_with_division<90000>(a, b));
+        REQUIRE(agrees_with_division<std::int64_t{1} << 62>(a, b));
+        REQUIRE(agrees_with_division<999999999989>(a, b));
+        REQUIRE(agrees_with_division<1>(a, b >> 24));
+    }
+}
+
+TEST_CASE("Fixed-denominator rationals can be compared")
+{
+    constexpr timestamp a = 1;
+    constexpr timestamp b = std::ratio<3, 2>{};
+
+    static_assert(a == a, "");
+    static_assert(a != b, "");
+    static_assert(a < b, "");
+    static_assert(b > a, "");
+    static_assert(a <= a, "");
+    static_assert(b >= a, "");
+}
+
+TEST_CASE("Fixed-denominator rationals can be printed")
+{
+    std::ostringstream ss;
+    ss << timestamp::from_num(30000);
+    REQUIRE(ss.str() == "1/3");
+}
@@ -0,0 +1,216 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "catch.hpp"
+
+#include <tcb/modular.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr std::uint64_t small_prime = 1000003;
+constexpr std::uint64_t large_prime = (std::uint64_t{1} << 62) - 57;
+
+using small_field = tcb::modular_rational<small_prime>;
+using large_field = tcb::modular_rational<large_prime>;
+
+using matrix = std::vector<std::vector<long long>>;
+
+// a * b mod p, computed with big integers
+std::uint64_t reference_multiply(std::uint64_t a, std::uint64_t b, std::uint64_t p)
+{
+    return static_cast<std::uint64_t>(tcb::big_integer{a} * tcb::big_integer{b} % tcb::big_integer{p});
+}
+
+// Solves a x = b by Gaussian elimination over F, returning false if the
+// matrix is singular
+template <typename F, typename Int>
+bool solve(const std::vector<std::vector<Int>>& a, const std::vector<Int>& b, std::vector<F>& x)
+{
+    const std::size_t n = b.size();
+    std::vector<std::vector<F>> m(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (const auto& elem : a[i]) {
+            m[i].push_back(F(elem));
+        }
+        m[i].push_back(F(b[i]));
+    }
+    for (std::size_t col = 0; col < n; ++col) {
+        std::size_t pivot = col;
+        while (pivot < n && m[pivot][col] == F{}) {
+            ++pivot;
+        }
+        if (pivot == n) {
+            return false;
+        }
+        std::swap(m[col], m[pivot]);
+        const F inverse = F{1} / m[col][col];
+        for (auto& elem : m[col]) {
+            elem = elem * inverse;
+        }
+        for (std::size_t row = 0; row < n; ++row) {
+            if (row != col && !(m[row][col] == F{})) {
+                const F factor = m[row][col];
+                for (std::size_t k = col; k <= n; ++k) {
+                    m[row][k] = m[row][k] - factor * m[col][k];
+                }
+            }
+        }
+    }
+    x.clear();
+    for (std::size_t i = 0; i < n; ++i) {
+        x.push_back(m[i][n]);
+    }
+    return true;
+}
+
+}
+
+TEST_CASE("Montgomery arithmetic")
+{
+    constexpr tcb::montgomery_modulus field{large_prime};
+    static_assert(field.from_montgomery(field.to_montgomery(12345)) == 12345, "");
+    static_assert(field.from_montgomery(field.multiply(field.to_montgomery(large_prime - 1),
+                                                       field.to_montgomery(large_prime - 1))) == 1, "");
+
+    std::mt19937_64 gen{48};
+    for (const std::uint64_t p : {std::uint64_t{3}, small_prime, large_prime,
+                                  (std::uint64_t{1} << 63) - 25}) {
+        const tcb::montgomery_modulus mod{p};
+        std::uniform_int_distribution<std::uint64_t> dist{0, p - 1};
+        for (int i = 0; i < 2000; ++i) {
+            const std::uint64_t a = dist(gen), b = dist(gen);
+            const auto ma = mod.to_montgomery(a), mb = mod.to_montgomery(b);
+            REQUIRE(mod.from_montgomery(ma) == a);
+            REQUIRE(mod.from_montgomery(mod.multiply(ma, mb)) == reference_multiply(a, b, p));
+            REQUIRE(mod.from_montgomery(mod.add(ma, mb)) == (a + b) % p);
+            REQUIRE(mod.from_montgomery(mod.subtract(ma, mb)) == (a + (p - b)) % p);
+            if (a != 0) {
+                REQUIRE(reference_multiply(a, mod.inverse_residue(a), p) == 1);
+            }
+        }
+    }
+}
+
+TEST_CASE("Modular rationals")
+{
+    REQUIRE(small_field{-1}.value() == small_prime - 1);
+    REQUIRE(small_field{small_prime + 5}.value() == 5);
+    REQUIRE(large_field{-1LL}.value() == large_prime - 1);
+    REQUIRE(small_field{}.is_zero());
+
+    // 1/3 is the element which gives 1 when tripled
+    const small_field third{tcb::rational<int>{1, 3}};
+    REQUIRE(third * small_field{3} == small_field{1});
+    REQUIRE(third == small_field{1} / small_field{3});
+    REQUIRE(third.inverse() == small_field{3});
+    const large_field minus_two_sevenths{tcb::rational<long long>{-2, 7}};
+    REQUIRE(minus_two_sevenths * large_field{7} == large_field{-2});
+
+    // Conversions from big numbers agree with those from machine integers
+    const tcb::big_integer big = tcb::big_integer{1} * tcb::big_integer{large_prime} * 1000 + 17;
+    REQUIRE(large_field{big}.value() == 17);
+    REQUIRE(large_field{-big}.value() == large_prime - 17);
+    const large_field big_fraction{tcb::big_rational{5, -big}};
+    REQUIRE(big_fraction == large_field{-5} / large_field{17});
+
+    // Fermat's little theorem
+    for (int x = 1; x < 100; ++x) {
+        REQUIRE(pow(small_field{x}, small_prime - 1) == small_field{1});
+        REQUIRE(pow(large_field{x}, large_prime - 2) == large_field{x}.inverse());
+    }
+    REQUIRE(-small_field{5} + small_field{5} == small_field{});
+    REQUIRE(small_field{2} - small_field{5} == small_field{-3});
+}
+
+TEST_CASE("Rational reconstruction")
+{
+    using tcb::big_integer;
+    using tcb::big_rational;
+
+    const big_integer m{large_prime};
+    for (const auto& expected : {big_rational{22, 7}, big_rational{-355, 113},
+                                 big_rational{0}, big_rational{1, 1000000}}) {
+        const big_integer residue{large_field{expected}.value()};
+        big_rational result;
+        REQUIRE(tcb::rational_reconstruction(residue, m, result));
+        REQUIRE(result == expected);
+    }
+
+    // Too large to be unique with a single prime
+    big_rational result;
+    const big_rational huge{big_integer{1} * 3000000000LL, big_integer{1} * 3000000001LL};
+    const big_integer residue{large_field{huge}.value()};
+    REQUIRE_FALSE((tcb::rational_reconstruction(residue, m, result) && result == huge));
+}
+
+TEST_CASE("Multi-modular linear solving")
+{
+    using tcb::big_rational;
+
+    const matrix a{{3, 1, 4, 1}, {5, 9, 2, 6}, {5, 3, 5, 8}, {9, 7, 9, 3}};
+    const std::vector<long long> b{2, 7, 1, 8};
+
+    std::vector<big_rational> expected;
+    REQUIRE(solve(a, b, expected));
+
+    // Including more threads than primes, which are capped at one round
+    for (std::size_t threads : {1, 3, 16, 32}) {
+        std::atomic<int> calls{0};
+        std::vector<big_rational> result;
+        tcb::multimodular_options options;
+        options.threads = threads;
+        REQUIRE(tcb::multimodular([&](auto, auto& out) {
+            ++calls;
+            return solve(a, b, out);
+        }, result, options));
+        REQUIRE(result == expected);
+        // Small answers need only the first prime and a confirming one,
+        // which a round of several primes already has
+        REQUIRE(calls == int(std::max<std::size_t>(std::min<std::size_t>(threads, 16), 2)));
+    }
+
+    // Entries too large for one prime; the solution has numerators and
+    // denominators of about 200 bits
+    const long long big = 999999999989LL;
+    const matrix hilbert_like{{big, 2, 3, 5, 7}, {11, big - 2, 13, 17, 19},
+                              {23, 29, big - 4, 31, 37}, {41, 43, 47, big - 6, 53},
+                              {59, 61, 67, 71, big - 8}};
+    const std::vector<long long> rhs{1, -1, 2, -2, 3};
+    REQUIRE(solve(hilbert_like, rhs, expected));
+    std::vector<big_rational> result;
+    tcb::multimodular_options options;
+    options.threads = 1;
+    int calls = 0;
+    REQUIRE(tcb::multimodular([&](auto, auto& out) {
+        ++calls;
+        return solve(hilbert_like, rhs, out);
+    }, result, options));
+    REQUIRE(result == expected);
+    REQUIRE(calls < 16);
+
+    // A prime at which the computation fails is skipped
+    int unlucky = 0;
+    REQUIRE(tcb::multimodular([&](auto zero, auto& out) {
+        if (decltype(zero)::modulus == large_prime) {
+            ++unlucky;
+            return false;
+        }
+        return solve(a, b, out);
+    }, result, options));
+    REQUIRE(unlucky == 1);
+    REQUIRE(solve(a, b, expected));
+    REQUIRE(result == expected);
+
+    // Giving up when the primes run out
+    options.max_primes = 2;
+    REQUIRE_FALSE(tcb::multimodular([&](auto, auto& out) {
+        return solve(hilbert_like, rhs, out);
+    }, result, options));
+}
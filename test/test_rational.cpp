@@ -732,6 +732,55 @@ TEST_CASE("Unary arithmentic operators work as expected")
     test_unary_arithmetic<std::intmax_t>();
 }
 
+TEST_CASE("Normalized construction skips reduction")
+{
+    constexpr tcb::rational<int> r{tcb::normalized, -3, 4};
+    static_assert(r.num() == -3 && r.denom() == 4, "");
+
+    constexpr auto neg = -r;
+    static_assert(neg.num() == 3 && neg.denom() == 4, "");
+
+    constexpr auto recip = tcb::reciprocal(r);
+    static_assert(recip.num() == -4 && recip.denom() == 3, "");
+    REQUIRE(tcb::reciprocal(tcb::rational<int>{5}) == tcb::rational<int>(1, 5));
+    REQUIRE(tcb::reciprocal(tcb::rational<int>{-1, 7}) == -7);
+
+    constexpr auto narrowed = static_cast<tcb::rational8_t>(tcb::rational<long>{-100, 3});
+    static_assert(narrowed.num() == -100 && narrowed.denom() == 3, "");
+}
+
+TEST_CASE("Rationals can be raised to integer powers")
+{
+    using r = tcb::rational<int>;
+    static_assert(tcb::pow(r{2, 3}, 0) == 1, "");
+    static_assert(tcb::pow(r{-2, 3}, 3) == r(-8, 27), "");
+    static_assert(tcb::pow(r{-2, 3}, -3) == r(-27, 8), "");
+    static_assert(tcb::pow(r{0}, 5) == 0, "");
+    static_assert(tcb::pow(r{-1, 7}, -1) == -7, "");
+    static_assert(tcb::pow(tcb::rational<unsigned>{3, 2}, 4u) == tcb::rational<unsigned>(81, 16), "");
+    REQUIRE(tcb::pow(tcb::rational64_t{3, 2}, 39) ==
+            tcb::rational64_t(4052555153018976267LL, 549755813888LL));
+
+    tcb::rational8_t out{5};
+    REQUIRE(tcb::checked_pow(tcb::rational8_t{2}, 6, out));
+    REQUIRE(out == 64);
+    REQUIRE_FALSE(tcb::checked_pow(tcb::rational8_t{2}, 7, out));
+    REQUIRE(out == 64);
+    REQUIRE(tcb::checked_pow(tcb::rational8_t{-2}, 7, out));
+    REQUIRE(out == -128);
+    // 11^2 and 12^2 are not decided by bit lengths alone
+    REQUIRE(tcb::checked_pow(tcb::rational8_t{11, 3}, 2, out));
+    REQUIRE(out == tcb::rational8_t(121, 9));
+    REQUIRE_FALSE(tcb::checked_pow(tcb::rational8_t{5, 12}, -2, out));
+    REQUIRE(tcb::checked_pow(tcb::rational8_t{-1, 5}, -3, out));
+    REQUIRE(out == -125);
+    REQUIRE_FALSE(tcb::checked_pow(tcb::rational8_t{0}, -1, out));
+    REQUIRE_FALSE(tcb::checked_pow(tcb::rational8_t{-128}, -1, out));
+    REQUIRE_FALSE(tcb::checked_pow(tcb::rational8_t{1, 2}, 1000000000, out));
+    REQUIRE(tcb::checked_pow(tcb::rational8_t{-1}, 1000000001, out));
+    REQUIRE(out == -1);
+}
+
 /*
  * Test binary arithmetic operators
  */
@@ -752,6 +801,32 @@ TEST_CASE("Binary arithmetic operators work as expected")
     test_binary_arithmetic<std::uintmax_t>();
 }
 
+TEST_CASE("Integer and shared-denominator operands are reduced")
+{
+    using r = tcb::rational<int>;
+    static_assert(r{1, 4} + r{1, 4} == r{1, 2}, "");
+    static_assert(r{3, 4} - r{1, 4} == r{1, 2}, "");
+    static_assert(r{3, 4} + r{1, 4} == 1, "");
+    static_assert(r{3, 4} / r{3, 4} == 1, "");
+    static_assert(r{-3, 4} / r{1, 4} == -3, "");
+    static_assert(r{3, 4} + 1 == r{7, 4}, "");
+    static_assert(2 - r{3, 4} == r{5, 4}, "");
+    static_assert(r{3, 4} * 2 == r{3, 2}, "");
+    static_assert(4 * r{3, 4} == 3, "");
+    static_assert(r{3, 4} * 0 == 0, "");
+    static_assert(r{6} * r{-7} == -42, "");
+
+    r x{5, 6};
+    x += r{1, 6};
+    REQUIRE(x == 1);
+    x *= 3;
+    REQUIRE(x == 3);
+    x /= r{9, 2};
+    REQUIRE(x == r(2, 3));
+    x -= 1;
+    REQUIRE(x == r(-1, 3));
+}
+
 TEST_CASE("Binary arithmetic operators of different types work as expected")
 {
     // Just test a few
@@ -760,6 +835,132 @@ TEST_CASE("Binary arithmetic operators of different types work as expected")
     test_binary_arithmetic<long long, unsigned int>();
 }
 
+TEST_CASE("Result type policies select the expected types")
+{
+    using tcb::rational_result_t;
+    using tcb::rational8_t;
+    using tcb::rational16_t;
+    using tcb::rational32_t;
+    using tcb::rational64_t;
+    using promote = tcb::promote_result_policy;
+    using preserve = tcb::preserve_result_policy;
+    using widen = tcb::widen_result_policy;
+
+    // Promotion follows the usual arithmetic conversions
+    static_assert(std::is_same<rational_result_t<rational8_t, rational8_t, promote>,
+                               tcb::rational<int>>::value, "");
+    static_assert(std::is_same<rational_result_t<rational16_t, long, promote>,
+                               tcb::rational<long>>::value, "");
+    static_assert(std::is_same<rational_result_t<rational32_t, std::kilo, promote>,
+                               rational32_t>::value, "");
+
+    // Preservation keeps the width of the widest rational operand
+    static_assert(std::is_same<rational_result_t<rational8_t, rational8_t, preserve>,
+                               rational8_t>::value, "");
+    static_assert(std::is_same<rational_result_t<rational8_t, rational16_t, preserve>,
+                               rational16_t>::value, "");
+    static_assert(std::is_same<rational_result_t<rational8_t, int, preserve>,
+                               rational8_t>::value, "");
+    static_assert(std::is_same<rational_result_t<long, rational16_t, preserve>,
+                               rational16_t>::value, "");
+    static_assert(std::is_same<rational_result_t<rational32_t, std::kilo, preserve>,
+                               rational32_t>::value, "");
+    static_assert(std::is_same<rational_result_t<tcb::rational<std::int_least32_t>,
+                                                 tcb::rational<std::uint_least32_t>,
+                                                 preserve>,
+                               tcb::rational<std::uint_least32_t>>::value, "");
+
+    // Widening goes to the next size up, stopping at std::intmax_t
+    static_assert(std::is_same<rational_result_t<rational8_t, rational8_t, widen>,
+                               rational16_t>::value, "");
+    static_assert(std::is_same<rational_result_t<rational16_t, rational32_t, widen>,
+                               rational64_t>::value, "");
+    static_assert(std::is_same<rational_result_t<rational64_t, int, widen>,
+                               rational64_t>::value, "");
+
+    // Products are formed at double width, including for 64-bit operands
+    // where 128-bit integers are available
+    using tcb::detail::rational_compute_t;
+    static_assert(std::is_same<rational_compute_t<rational8_t, rational8_t, preserve>,
+                               std::int_least16_t>::value, "");
+    static_assert(std::is_same<rational_compute_t<rational32_t, rational16_t, widen>,
+                               std::int_least64_t>::value, "");
+    static_assert(std::is_same<rational_compute_t<rational64_t, rational64_t, preserve>,
+                               tcb::detail::double_width_t<std::int_least64_t>>::value, "");
+    static_assert(std::is_same<rational_compute_t<rational64_t, int, widen>,
+                               tcb::detail::double_width_t<std::int_least64_t>>::value, "");
+#if defined(TCB_RATIONAL_HAVE_INT128) && !defined(__STRICT_ANSI__)
+    static_assert(std::is_same<tcb::detail::double_width_t<std::int_least64_t>,
+                               tcb::detail::int128_t>::value, "");
+#endif
+
+    // Without a specialisation, the default policy applies to the operators
+    static_assert(std::is_same<decltype(rational8_t{} + rational8_t{}),
+                               tcb::rational<int>>::value, "");
+}
+
+TEST_CASE("Arithmetic with compile-time constants preserves width")
+{
+    using tcb::rational16_t;
+    using tcb::rational32_t;
+    using tcb::static_rational;
+    using ntsc = static_rational<30000, 1001>;
+
+    static_assert(std::is_same<decltype(rational32_t{} * ntsc{}), rational32_t>::value, "");
+    static_assert(std::is_same<decltype(std::milli{} + rational32_t{}), rational32_t>::value, "");
+    static_assert(std::is_same<decltype(rational16_t{} / std::kilo{}), tcb::rational<int>>::value, "");
+    static_assert(std::is_same<decltype(ntsc{} * static_rational<1001, 1000>{}),
+                               static_rational<30, 1>>::value, "");
+    static_assert(std::is_same<decltype(ntsc{} - std::ratio<30>{}),
+                               static_rational<-30, 1001>>::value, "");
+
+    static_assert(static_rational<10, 4>::num() == 5, "");
+    static_assert(static_rational<10, 4>::denom() == 2, "");
+    static_assert(static_rational<3, -6>::num() == -1, "");
+    static_assert(static_cast<rational32_t>(static_rational<10, 4>{}) == rational32_t{5, 2}, "");
+
+#ifdef TCB_HAVE_CONSTEXPR14
+    static_assert(rational32_t{1001, 2} * ntsc{} == 15000, "");
+    static_assert(rational32_t{1, 3} + std::ratio<1, 6>{} == rational32_t{1, 2}, "");
+#endif
+
+    // Each result matches the general-purpose operators on the equivalent
+    // rational<int>, and is in canonical form
+    const auto check = [](rational32_t actual, tcb::rational<long long> expected) {
+        REQUIRE(actual.num() == expected.num());
+        REQUIRE(actual.denom() == expected.denom());
+    };
+
+    for (int n = -12; n <= 12; ++n) {
+        for (int d = 1; d <= 12; ++d) {
+            const rational32_t r{n, d};
+            const tcb::rational<long long> w{n, d};
+
+            check(r + ntsc{}, w + tcb::rational<long long>{30000, 1001});
+            check(r - ntsc{}, w - tcb::rational<long long>{30000, 1001});
+            check(ntsc{} - r, tcb::rational<long long>{30000, 1001} - w);
+            check(r * ntsc{}, w * tcb::rational<long long>{30000, 1001});
+            check(r / ntsc{}, w / tcb::rational<long long>{30000, 1001});
+
+            check(r + std::ratio<-3>{}, w - 3);
+            check(r * std::ratio<6>{}, w * 6);
+            check(r * std::ratio<1, 6>{}, w / 6);
+            check(r * std::ratio<-4, 9>{}, w * tcb::rational<long long>{-4, 9});
+            check(r / std::ratio<-4, 9>{}, w / tcb::rational<long long>{-4, 9});
+            check(std::ratio<3, 4>{} + r, w + tcb::rational<long long>{3, 4});
+
+            if (n != 0) {
+                check(std::ratio<-4, 9>{} / r, tcb::rational<long long>{-4, 9} / w);
+            }
+        }
+    }
+
+    // The constant is cross-cancelled before multiplying, so products whose
+    // intermediate terms would overflow stay in range
+    const rational32_t big{2000000000, 1001};
+    check(big * static_rational<1001, 2>{}, tcb::rational<long long>{1000000000});
+}
+
 TEST_CASE("Relational assignment operators work as expected")
 {
     test_relational_assignment<char>();
@@ -0,0 +1,91 @@
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Tests for features which require C++20
+
+#include "catch.hpp"
+
+#include <tcb/continued_fraction.hpp>
+#include <tcb/rational_multiplier.hpp>
+#include <tcb/rational_sequences.hpp>
+
+#include <algorithm>
+#include <ranges>
+
+using namespace tcb::rational_literals;
+
+namespace {
+
+template <tcb::rational<int> R>
+constexpr int num_of()
+{
+    return R.num();
+}
+
+}
+
+TEST_CASE("Rationals can be used as non-type template parameters")
+{
+    static_assert(num_of<tcb::rational<int>{2, 4}>() == 1);
+    static_assert(num_of<3/10_r>() == 3);
+    static_assert(std::is_same_v<decltype(num_of<1/2_r>), decltype(num_of<2/4_r>)>);
+}
+
+TEST_CASE("static_scale accepts rational constants")
+{
+    static_assert(tcb::static_scale<1001/30000_r>(30000) == 1001);
+    static_assert(tcb::static_scale<-3/4_r>(10, tcb::rounding::down) == -8);
+
+    for (std::int64_t x = -1000000; x <= 1000000; x += 999) {
+        REQUIRE(tcb::static_scale<1001/30000_r>(x) == x * 1001 / 30000);
+        constexpr auto r = tcb::rational64_t{90000, 1001};
+        using ratio = std::ratio<90000, 1001>;
+        REQUIRE(tcb::static_scale<r>(x, tcb::rounding::nearest) ==
+                tcb::static_scale<ratio>(x, tcb::rounding::nearest));
+    }
+}
+
+TEST_CASE("Continued fraction views are ranges")
+{
+    using view = tcb::convergents_view<int>;
+    static_assert(std::ranges::view<view>);
+    static_assert(std::ranges::forward_range<view>);
+    static_assert(std::ranges::borrowed_range<view>);
+    static_assert(std::ranges::forward_range<tcb::continued_fraction_view<int>>);
+    static_assert(std::ranges::forward_range<tcb::semiconvergents_view<int>>);
+
+    // Few enough digits that the differences below fit in 64 bits
+    const tcb::rational64_t pi{314159265, 100000000};
+
+    // The pipeline stops at the first convergent with too large a denominator
+    auto small = tcb::views::convergents(pi)
+               | std::views::take_while([](auto c) { return c.denom() <= 200; });
+    REQUIRE(std::ranges::distance(small) == 4);
+
+    const auto close = std::ranges::find_if(tcb::views::convergents(pi), [&](auto c) {
+        const auto error = c - pi;
+        return error < 1/10000000_r && error > -1/10000000_r;
+    });
+    REQUIRE(*close == tcb::rational64_t(102573, 32650));
+
+    REQUIRE(std::ranges::max(tcb::views::continued_fraction(pi)) == 288);
+    static_assert(std::ranges::count(tcb::views::semiconvergents(415/93_r), 1,
+                                     [](auto s) { return s.denom(); }) == 2);
+}
+
+TEST_CASE("Rational sequences are ranges")
+{
+    static_assert(std::ranges::forward_range<tcb::farey_sequence_view<int>>);
+    static_assert(std::ranges::borrowed_range<tcb::farey_sequence_view<int>>);
+    static_assert(std::ranges::sized_range<tcb::calkin_wilf_view<int>>);
+    static_assert(std::ranges::sized_range<tcb::stern_brocot_view<int>>);
+
+    // The first fraction after 1/3 with denominator at most 100
+    const auto it = std::ranges::upper_bound(tcb::farey_sequence(100), 1/3_r);
+    REQUIRE(*it == 33/98_r);
+
+    auto big = tcb::calkin_wilf_sequence<int>(1000)
+             | std::views::filter([](auto f) { return f > 3; });
+    REQUIRE(*std::ranges::begin(big) == 4);
+}
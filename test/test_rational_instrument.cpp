@@ -0,0 +1,103 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Built with TCB_RATIONAL_INSTRUMENT defined
+
+#include "catch.hpp"
+
+#include <tcb/rational.hpp>
+#include <tcb/rational_interval.hpp>
+
+#include <thread>
+
+using tcb::rational_operation;
+
+TEST_CASE("Instrumentation counts operations, simplifications and GCDs")
+{
+    tcb::reset_rational_counters();
+
+    const tcb::rational<int> a{6, 8};
+    const tcb::rational<int> b{1, 6};
+    auto counters = tcb::rational_counters_snapshot();
+    REQUIRE(counters.simplify_calls == 2);
+    REQUIRE(counters.gcd_calls == 2);
+    // gcd(6, 8) takes three iterations, gcd(1, 6) two
+    REQUIRE(counters.gcd_iterations == 5);
+
+    auto c = a + b;
+    c -= b;
+    c = c * b / a;
+    REQUIRE(c == b);
+    REQUIRE_FALSE(c < b);
+    REQUIRE(c >= b);
+
+    counters = tcb::rational_counters_snapshot();
+    REQUIRE(counters[rational_operation::add] == 1);
+    REQUIRE(counters[rational_operation::subtract] == 1);
+    REQUIRE(counters[rational_operation::multiply] == 1);
+    REQUIRE(counters[rational_operation::divide] == 1);
+    REQUIRE(counters[rational_operation::equality] == 1);
+    REQUIRE(counters[rational_operation::ordering] == 2);
+    REQUIRE(counters.simplify_calls == 6);
+
+    tcb::reset_rational_counters();
+    counters = tcb::rational_counters_snapshot();
+    REQUIRE(counters.simplify_calls == 0);
+    REQUIRE(counters[rational_operation::add] == 0);
+}
+
+TEST_CASE("Instrumentation is not invoked during constant evaluation")
+{
+    tcb::reset_rational_counters();
+    constexpr tcb::rational<int> r = tcb::rational<int>{2, 4} + tcb::rational<int>{1, 4};
+    static_assert(r == tcb::rational<int>(3, 4), "");
+    REQUIRE(tcb::rational_counters_snapshot().simplify_calls == 0);
+}
+
+TEST_CASE("Instrumentation records near-overflow events")
+{
+    tcb::reset_rational_counters();
+
+    const tcb::rational<std::int16_t> small{3, 4};
+    REQUIRE(tcb::rational_counters_snapshot().near_overflows == 0);
+    REQUIRE(tcb::rational_counters_snapshot().min_headroom_bits == 12);
+
+    // The unreduced numerator 30000 uses all 15 value bits of int16_t
+    const tcb::rational<std::int16_t> big{30000, 2};
+    REQUIRE(big == 15000);
+    const auto counters = tcb::rational_counters_snapshot();
+    REQUIRE(counters.near_overflows == 1);
+    REQUIRE(counters.min_headroom_bits == 0);
+}
+
+TEST_CASE("Instrumentation counters are per thread")
+{
+    tcb::reset_rational_counters();
+    std::thread{[] {
+        const tcb::rational<int> r{2, 4};
+        REQUIRE(tcb::rational_counters_snapshot().simplify_calls == 1);
+    }}.join();
+    REQUIRE(tcb::rational_counters_snapshot().simplify_calls == 0);
+}
+
+TEST_CASE("Interval products form only the products which can be bounds")
+{
+    using r = tcb::rational<int>;
+    using interval = tcb::rational_interval<int>;
+    const interval positive{r(1, 2), r(3, 4)};
+    const interval negative{r(-5, 3), r(-1, 3)};
+    const interval mixed{r(-1, 3), r(2, 3)};
+
+    const auto multiplies = [](const interval& a, const interval& b) {
+        tcb::reset_rational_counters();
+        (void) (a * b);
+        return tcb::rational_counters_snapshot()[rational_operation::multiply];
+    };
+    REQUIRE(multiplies(positive, positive) == 2);
+    REQUIRE(multiplies(positive, negative) == 2);
+    REQUIRE(multiplies(negative, mixed) == 2);
+    REQUIRE(multiplies(mixed, positive) == 2);
+    REQUIRE(multiplies(mixed, mixed) == 4);
+}
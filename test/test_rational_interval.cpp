@@ -0,0 +1,147 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "catch.hpp"
+
+#include <tcb/rational_interval.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+
+namespace {
+
+using r = tcb::rational<int>;
+using interval = tcb::rational_interval<int>;
+
+// The hull of the four products, in a wider type
+interval reference_product(const interval& a, const interval& b)
+{
+    using wide = tcb::rational<long long>;
+    const auto widen = [](const r& x) { return wide(x.num(), x.denom()); };
+    const wide products[] = {widen(a.lower()) * widen(b.lower()), widen(a.lower()) * widen(b.upper()),
+                             widen(a.upper()) * widen(b.lower()), widen(a.upper()) * widen(b.upper())};
+    const auto lo = *std::min_element(std::begin(products), std::end(products));
+    const auto hi = *std::max_element(std::begin(products), std::end(products));
+    return {r(static_cast<int>(lo.num()), static_cast<int>(lo.denom())),
+            r(static_cast<int>(hi.num()), static_cast<int>(hi.denom()))};
+}
+
+}
+
+TEST_CASE("Interval arithmetic")
+{
+    const interval a{r(1, 2), r(3, 4)};
+    const interval b{r(-1, 3), r(2, 3)};
+
+    REQUIRE(a + b == interval(r(1, 6), r(17, 12)));
+    REQUIRE(a - b == interval(r(-1, 6), r(13, 12)));
+    REQUIRE(-b == interval(r(-2, 3), r(1, 3)));
+    REQUIRE(a * b == interval(r(-1, 4), r(1, 2)));
+    REQUIRE(b / a == interval(r(-2, 3), r(4, 3)));
+    REQUIRE(a * r(2) == interval(r(1), r(3, 2)));
+    REQUIRE(interval{r(5)}.is_point());
+
+    auto c = a;
+    c *= c;
+    c -= r(1, 4);
+    REQUIRE(c == interval(r(0), r(5, 16)));
+
+    std::mt19937 gen{47};
+    std::uniform_int_distribution<int> num_dist(-20, 20);
+    std::uniform_int_distribution<int> denom_dist(1, 20);
+    const auto random_interval = [&] {
+        r lo{num_dist(gen), denom_dist(gen)};
+        r hi{num_dist(gen), denom_dist(gen)};
+        if (hi < lo) {
+            std::swap(lo, hi);
+        }
+        return interval{lo, hi};
+    };
+    for (int i = 0; i < 20000; ++i) {
+        const auto x = random_interval();
+        const auto y = random_interval();
+        REQUIRE(x * y == reference_product(x, y));
+        if (!y.contains(r(0))) {
+            const interval recip{tcb::reciprocal(y.upper()), tcb::reciprocal(y.lower())};
+            REQUIRE(x / y == reference_product(x, recip));
+        }
+        const auto sum = x + y;
+        REQUIRE(sum.contains(x.lower() + y.upper()));
+        REQUIRE(sum.lower() == x.lower() + y.lower());
+    }
+}
+
+TEST_CASE("Interval queries do not overflow")
+{
+    using T = std::int64_t;
+    using r64 = tcb::rational64_t;
+    const T max = std::numeric_limits<T>::max();
+    const T min = std::numeric_limits<T>::min();
+
+    const tcb::rational_interval<T> i{r64(max - 2, max - 1), r64(max - 1, max)};
+    REQUIRE(i.contains(i.lower()));
+    REQUIRE(i.contains(i.upper()));
+    REQUIRE_FALSE(i.contains(r64(1)));
+    REQUIRE_FALSE(i.contains(r64(max - 3, max - 2)));
+    REQUIRE(i.contains(tcb::rational_interval<T>{i.upper()}));
+    REQUIRE(tcb::rational_interval<T>(r64(min), r64(max)).contains(r64(min + 1, max)));
+    REQUIRE_FALSE(tcb::rational_interval<T>(r64(-1), r64(max, max - 1)).contains(r64(min, max)));
+
+    // The width 1/((max - 1) max) is not representable, and the smallest
+    // fraction above it with components in T is 1/max
+    REQUIRE(i.width() == r64(1, max));
+
+    REQUIRE(tcb::rational_interval<T>(r64(-3, 4), r64(5, 6)).width() == r64(19, 12));
+    REQUIRE(tcb::rational_interval<T>(r64(min), r64(max)).width() == r64(max));
+    REQUIRE(tcb::rational_interval<T>(r64(-1, max), r64(max - 1, max)).width() == r64(1));
+
+    using r8 = tcb::rational8_t;
+    using T8 = std::int_least8_t;
+    // 127/1 - (-128)/127 = 16257/127, above the maximum
+    REQUIRE(tcb::rational_interval<T8>(r8(T8{-128}, T8{127}), r8(T8{127})).width() == r8(T8{127}));
+    // 100/127 - (-1/126) = 12727/16002, which rounds up to the smallest
+    // fraction above it with a denominator of at most 127
+    const auto w8 = tcb::rational_interval<T8>(r8(T8{-1}, T8{126}), r8(T8{100}, T8{127})).width();
+    r expected{1};
+    for (int q = 1; q <= 127; ++q) {
+        expected = std::min(expected, r((12727 * q + 16001) / 16002, q));
+    }
+    REQUIRE(r(w8.num(), w8.denom()) == expected);
+}
+
+TEST_CASE("Intervals can be coarsened outward")
+{
+    const interval i{r(355, 113), r(22, 7)};
+    const auto c = tcb::coarsen(i, 10);
+    REQUIRE(c.contains(i));
+    REQUIRE(c == interval(r(25, 8), r(22, 7)));
+    REQUIRE(tcb::coarsen(i, 113) == i);
+    REQUIRE(tcb::coarsen(-i, 10) == -c);
+    REQUIRE(tcb::coarsen(interval{r(1, 3), r(1, 2)}, 1) == interval(r(0), r(1)));
+
+    // Every bound moves to its nearest neighbour in the Farey sequence
+    std::mt19937 gen{7};
+    std::uniform_int_distribution<int> num_dist(-500, 500);
+    std::uniform_int_distribution<int> denom_dist(1, 500);
+    for (int n = 0; n < 500; ++n) {
+        const r x{num_dist(gen), denom_dist(gen)};
+        const int max_denom = denom_dist(gen) / 10 + 1;
+        const auto b = tcb::coarsen(interval{x}, max_denom);
+        REQUIRE(b.lower() <= x);
+        REQUIRE(x <= b.upper());
+        REQUIRE(b.lower().denom() <= max_denom);
+        REQUIRE(b.upper().denom() <= max_denom);
+        for (int d = 1; d <= max_denom; ++d) {
+            // No fraction with denominator d lies strictly between the
+            // bounds and x
+            for (int k = -2; k <= 2; ++k) {
+                const r candidate{static_cast<int>(static_cast<long long>(x.num()) * d / x.denom()) + k, d};
+                REQUIRE_FALSE((b.lower() < candidate && candidate < x));
+                REQUIRE_FALSE((x < candidate && candidate < b.upper()));
+            }
+        }
+    }
+}
@@ -0,0 +1,183 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "catch.hpp"
+
+#include <tcb/big_rational.hpp>
+#include <tcb/rational_key.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+template <typename T>
+std::vector<unsigned char> key_bytes(const tcb::rational<T>& value)
+{
+    const auto key = tcb::encode_key(value);
+    return {key.begin(), key.end()};
+}
+
+// memcmp() order, with a prefix ordered first
+int memcmp_order(const std::vector<unsigned char>& lhs, const std::vector<unsigned char>& rhs)
+{
+    const int cmp = std::memcmp(lhs.data(), rhs.data(), std::min(lhs.size(), rhs.size()));
+    if (cmp != 0) {
+        return cmp < 0 ? -1 : 1;
+    }
+    return lhs.size() == rhs.size() ? 0 : lhs.size() < rhs.size() ? -1 : 1;
+}
+
+template <typename T>
+bool round_trips(const tcb::rational<T>& value)
+{
+    const auto key = tcb::encode_key(value);
+    tcb::rational<T> decoded{12345 % std::numeric_limits<T>::max()};
+    return key.size() <= tcb::rational_key<T>::capacity &&
+           tcb::decode_key(key, decoded) && decoded == value;
+}
+
+}
+
+TEST_CASE("Rational keys sort like their values")
+{
+    using tcb::rational8_t;
+
+    // Every rational8_t, sorted by value
+    std::vector<rational8_t> values;
+    for (int num = -128; num <= 127; ++num) {
+        for (int denom = 1; denom <= 127; ++denom) {
+            const rational8_t r(num, denom);
+            if (r.num() == num && r.denom() == denom) {
+                values.push_back(r);
+            }
+        }
+    }
+    std::sort(values.begin(), values.end());
+    std::vector<std::vector<unsigned char>> keys;
+    for (const auto& value : values) {
+        keys.push_back(key_bytes(value));
+        REQUIRE(round_trips(value));
+    }
+    for (std::size_t i = 1; i < keys.size(); ++i) {
+        REQUIRE(memcmp_order(keys[i - 1], keys[i]) < 0);
+    }
+
+    // Keys depend only on the value
+    for (const auto& value : values) {
+        REQUIRE(key_bytes(tcb::rational64_t(value.num(), value.denom())) == key_bytes(value));
+    }
+
+    // Random 64-bit values, including extremes
+    const std::int64_t max = std::numeric_limits<std::int64_t>::max();
+    const std::int64_t min = std::numeric_limits<std::int64_t>::min();
+    std::vector<tcb::rational64_t> wide{{min, 1}, {min, max}, {max, 1}, {1, max},
+                                        {-1, max}, {min + 1, max}, {max - 1, max}, {max, max - 1}};
+    std::mt19937_64 gen{50};
+    for (const std::int64_t range : {std::int64_t{3}, std::int64_t{1000}, std::int64_t{1} << 40, max}) {
+        std::uniform_int_distribution<std::int64_t> dist{-range, range};
+        std::uniform_int_distribution<std::int64_t> denom_dist{1, range};
+        for (int i = 0; i < 500; ++i) {
+            wide.emplace_back(dist(gen), denom_dist(gen));
+        }
+    }
+    for (const auto& lhs : wide) {
+        REQUIRE(round_trips(lhs));
+        for (std::size_t j = 0; j < wide.size(); j += 37) {
+            const auto& rhs = wide[j];
+            // operator< could overflow, so compare exactly
+            const tcb::big_rational exact_lhs{lhs}, exact_rhs{rhs};
+            const int expected = exact_lhs < exact_rhs ? -1 : exact_rhs < exact_lhs ? 1 : 0;
+            REQUIRE(memcmp_order(key_bytes(lhs), key_bytes(rhs)) == expected);
+            REQUIRE(compare(tcb::encode_key(lhs), tcb::encode_key(rhs)) == expected);
+        }
+    }
+
+    static_assert(tcb::encode_key(tcb::rational<int>{1, 2}) < tcb::encode_key(tcb::rational<int>{2, 3}), "");
+    static_assert(tcb::encode_key(tcb::rational<int>{-3}) < tcb::encode_key(tcb::rational<int>{-1, 2}), "");
+}
+
+TEST_CASE("Rational keys are compact")
+{
+    using r = tcb::rational<int>;
+    REQUIRE(key_bytes(r{0}) == std::vector<unsigned char>{0x80});
+    REQUIRE(key_bytes(r{1}) == (std::vector<unsigned char>{0x81, 0x01, 0x00}));
+    REQUIRE(key_bytes(r{-1}) == (std::vector<unsigned char>{0x7F, 0xFE, 0xFF}));
+    REQUIRE(tcb::encode_key(r{245}).size() == 3);
+    REQUIRE(tcb::encode_key(r{246}).size() == 4);
+    REQUIRE(tcb::encode_key(r(1, 2)).size() == 4);
+    REQUIRE(tcb::encode_key(r(355, 113)).size() == 5);
+
+    // Ratios of consecutive Fibonacci numbers have the most terms
+    std::uint64_t a = 1, b = 1;
+    while (b <= static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max()) - a) {
+        const std::uint64_t next = a + b;
+        a = b;
+        b = next;
+    }
+    const tcb::rational64_t golden(static_cast<std::int64_t>(b), static_cast<std::int64_t>(a));
+    REQUIRE(round_trips(golden));
+    REQUIRE(tcb::encode_key(golden).size() > 90);
+
+    // Keys can also be written to strings, whose comparison is unsigned
+    std::string half, third;
+    tcb::encode_key(r(1, 2), std::back_inserter(half));
+    tcb::encode_key(r(-1, 3), std::back_inserter(third));
+    REQUIRE(third < half);
+}
+
+TEST_CASE("Decoding rational keys")
+{
+    using tcb::rational8_t;
+    rational8_t result{7};
+    auto decode = [&](std::vector<unsigned char> bytes) {
+        return tcb::decode_key(bytes.data(), bytes.size(), result);
+    };
+
+    // Malformed keys
+    REQUIRE_FALSE(decode({}));
+    REQUIRE_FALSE(decode({0x42}));
+    REQUIRE_FALSE(decode({0x80, 0x00}));          // trailing bytes
+    REQUIRE_FALSE(decode({0x81, 0x01}));          // no end marker
+    REQUIRE_FALSE(decode({0x81, 0x01, 0x00, 0x00}));
+    REQUIRE_FALSE(decode({0x81, 0xFF}));          // no terms
+    REQUIRE_FALSE(decode({0x81, 0x00, 0x00}));    // positive zero
+    REQUIRE_FALSE(decode({0x81, 0x00, 0xFE, 0xFF}));  // [0; 1] is 1
+    REQUIRE_FALSE(decode({0x81, 0x02, 0xFF, 0xFF}));  // a zero term
+    REQUIRE_FALSE(decode({0x81, 0xF7, 0x05, 0x00}));  // not the shortest coding
+    REQUIRE_FALSE(decode({0x81, 0xF7}));          // truncated term
+    REQUIRE(result == rational8_t{7});
+
+    // Values too large for the width
+    REQUIRE(decode(key_bytes(tcb::rational<int>{-128})));
+    REQUIRE(result == rational8_t{-128});
+    REQUIRE_FALSE(decode(key_bytes(tcb::rational<int>{128})));
+    REQUIRE_FALSE(decode(key_bytes(tcb::rational<int>(1, 128))));
+    REQUIRE(decode(key_bytes(tcb::rational<int>(-127, 125))));
+    REQUIRE(result == rational8_t(-127, 125));
+
+    // Negative values never fit in an unsigned type, including those whose
+    // first term is zero
+    tcb::rational<unsigned> positive{9};
+    for (const auto& key : {tcb::encode_key(tcb::rational<int>(-1, 2)),
+                            tcb::encode_key(tcb::rational<int>{-3}),
+                            tcb::encode_key(tcb::rational<int>(-5, 3))}) {
+        REQUIRE_FALSE(tcb::decode_key(key.data(), key.size(), positive));
+    }
+    REQUIRE(positive == tcb::rational<unsigned>{9});
+    const auto half = tcb::encode_key(tcb::rational<int>(1, 2));
+    REQUIRE(tcb::decode_key(half.data(), half.size(), positive));
+    REQUIRE(positive == tcb::rational<unsigned>(1, 2));
+
+    // Keys of one width decode into another
+    tcb::rational64_t wide;
+    const auto key = tcb::encode_key(rational8_t(-100, 77));
+    REQUIRE(tcb::decode_key(key.data(), key.size(), wide));
+    REQUIRE(wide == tcb::rational64_t(-100, 77));
+}
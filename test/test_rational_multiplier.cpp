@@ -0,0 +1,159 @@
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "catch.hpp"
+
+#include <tcb/rational_multiplier.hpp>
+
+#include <random>
+#include <vector>
+
+namespace {
+
+// Reference implementations using plain division in a wider type
+long long ref_floor(long long x, long long p, long long q)
+{
+    const long long n = x * p;
+    return n / q - ((n % q != 0) && ((n < 0) != (q < 0)));
+}
+
+long long ref_ceil(long long x, long long p, long long q)
+{
+    const long long n = x * p;
+    return n / q + ((n % q != 0) && ((n < 0) == (q < 0)));
+}
+
+template <typename T>
+void test_multiplier(T p, T q)
+{
+    const tcb::rational<T> r{p, q};
+    const tcb::rational_multiplier<T> m{r};
+    REQUIRE(m.value() == r);
+
+    std::mt19937 gen{static_cast<unsigned>(p * 31 + q)};
+    std::uniform_int_distribution<int> dist(-30000, 30000);
+    for (int i = 0; i < 500; ++i) {
+        const T x = static_cast<T>(dist(gen));
+        const long long n = static_cast<long long>(x) * r.num();
+        const long long fl = ref_floor(x, r.num(), r.denom());
+        const long long ce = ref_ceil(x, r.num(), r.denom());
+
+        REQUIRE(m.floor(x) == fl);
+        REQUIRE(m.ceil(x) == ce);
+        REQUIRE(m.multiply(x, tcb::rounding::toward_zero) == n / r.denom());
+
+        // Halfway cases go away from zero
+        const long long twice = 2 * n;
+        const long long nearest = twice >= 0 ? (twice + r.denom()) / (2 * r.denom())
+                                             : -((-twice + r.denom()) / (2 * r.denom()));
+        REQUIRE(m.round(x) == nearest);
+
+        const auto dm = m.divmod(x);
+        REQUIRE(dm.quot == x / r.denom());
+        REQUIRE(dm.rem == x % r.denom());
+
+        const int cmp = m.compare(x);
+        REQUIRE((cmp < 0) == (x < r));
+        REQUIRE((cmp == 0) == (x == r));
+        REQUIRE((cmp > 0) == (x > r));
+    }
+}
+
+}
+
+TEST_CASE("rational_multiplier matches division")
+{
+    test_multiplier<std::int32_t>(1001, 30000);
+    test_multiplier<std::int32_t>(-7, 3);
+    test_multiplier<std::int32_t>(5, 1);
+    test_multiplier<std::int32_t>(0, 1);
+    test_multiplier<std::int32_t>(1, 65536);
+    test_multiplier<std::int64_t>(90000, 1001);
+    test_multiplier<std::int64_t>(-1, 1000000007);
+    test_multiplier<std::int16_t>(3, 7);
+}
+
+TEST_CASE("rational_multiplier handles products wider than T")
+{
+    const tcb::rational_multiplier<std::int64_t> m{tcb::rational64_t{1000000000, 90001}};
+    const std::int64_t x = std::int64_t{1} << 40;
+    // x * 1e9 needs more than 64 bits
+    REQUIRE(m.floor(x) == 12216660123509738);
+    REQUIRE(m.floor(-x) == -12216660123509739);
+    REQUIRE(m.compare(x) > 0);
+    REQUIRE(m.compare(-x) < 0);
+    REQUIRE(m.compare(11111) > 0);
+    REQUIRE(m.compare(11110) < 0);
+}
+
+TEST_CASE("rational_multiplier batch operations match scalar ones")
+{
+    const tcb::rational_multiplier<std::int32_t> m{tcb::rational32_t{-1001, 30000}};
+
+    std::vector<std::int32_t> in;
+    for (int i = -5000; i < 5000; i += 7) {
+        in.push_back(i * 13);
+    }
+    std::vector<std::int32_t> out(in.size());
+    std::vector<std::int32_t> out2(in.size());
+
+    m.floor(in.begin(), in.end(), out.begin());
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        REQUIRE(out[i] == m.floor(in[i]));
+    }
+    m.ceil(in.begin(), in.end(), out.begin());
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        REQUIRE(out[i] == m.ceil(in[i]));
+    }
+    m.round(in.begin(), in.end(), out.begin());
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        REQUIRE(out[i] == m.round(in[i]));
+    }
+    m.divmod(in.begin(), in.end(), out.begin(), out2.begin());
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        REQUIRE(out[i] == in[i] / 30000);
+        REQUIRE(out2[i] == in[i] % 30000);
+    }
+}
+
+TEST_CASE("static_scale multiplies by a compile-time ratio")
+{
+    using ntsc = std::ratio<1001, 30000>;
+    using minus_five_eighths = std::ratio<-5, 8>;
+    using pow2 = std::ratio<1, 1024>;
+
+#ifdef TCB_HAVE_CONSTEXPR14
+    static_assert(tcb::static_scale<ntsc>(30000) == 1001, "");
+    static_assert(tcb::static_scale<std::ratio<3, 4>>(-10, tcb::rounding::down) == -8, "");
+#endif
+
+    for (std::int32_t x = -100000; x <= 100000; x += 37) {
+        const std::int64_t n = std::int64_t{x} * 1001;
+        REQUIRE(tcb::static_scale<ntsc>(x) == n / 30000);
+        REQUIRE(tcb::static_scale<minus_five_eighths>(x, tcb::rounding::down) ==
+                ref_floor(x, -5, 8));
+        REQUIRE(tcb::static_scale<std::ratio<7>>(x) == x * 7);
+    }
+
+    // Constants too large for a 32-bit word are applied in 64 bits
+    using tiny = std::ratio<1, 5000000000>;
+    REQUIRE(tcb::static_scale<tiny>(std::int32_t{2000000000}) == 0);
+    REQUIRE(tcb::static_scale<tiny>(std::int32_t{2000000000}, tcb::rounding::nearest) == 0);
+    REQUIRE(tcb::static_scale<tiny>(std::int32_t{-2000000000}, tcb::rounding::down) == -1);
+    using wide = std::ratio<3000000001, 4000000000>;
+    REQUIRE(tcb::static_scale<wide>(std::int16_t{-1000}) == -750);
+
+    // 64-bit values use a double-width product and a precomputed reciprocal
+    const tcb::rational_multiplier<std::int64_t> m{tcb::rational64_t{1001, 30000}};
+    for (std::int64_t x = -(std::int64_t{1} << 60); x < (std::int64_t{1} << 60);
+         x += std::int64_t{1} << 54) {
+        for (auto mode : {tcb::rounding::toward_zero, tcb::rounding::down,
+                          tcb::rounding::up, tcb::rounding::nearest}) {
+            REQUIRE(tcb::static_scale<ntsc>(x + 12345, mode) == m.multiply(x + 12345, mode));
+            const tcb::rational64_t from{1, 1024};
+            REQUIRE(tcb::static_scale<pow2>(x + 7, mode) ==
+                    tcb::rescale(x + 7, from, tcb::rational64_t{1}, mode));
+        }
+    }
+}
@@ -0,0 +1,62 @@
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "catch.hpp"
+
+#include <tcb/rational.hpp>
+
+// Use the preserving policy for rational8_t and rational64_t arithmetic, to
+// check that the customisation point is respected by the operators
+template <>
+struct tcb::rational_result_policy<tcb::rational8_t, tcb::rational8_t> {
+    using type = tcb::preserve_result_policy;
+};
+
+template <>
+struct tcb::rational_result_policy<tcb::rational64_t, tcb::rational64_t> {
+    using type = tcb::preserve_result_policy;
+};
+
+TEST_CASE("Result type policies can be customised")
+{
+    using tcb::rational8_t;
+    using tcb::rational16_t;
+
+    // The specialisation above applies to the operators, and only to the
+    // operand types it names
+    static_assert(std::is_same<decltype(rational8_t{} + rational8_t{}),
+                               rational8_t>::value, "");
+    static_assert(std::is_same<decltype(rational8_t{} * rational16_t{}),
+                               tcb::rational<int>>::value, "");
+
+    // Intermediate products are formed in a wider type, so results are
+    // exact when the reduced value fits
+    const rational8_t r1{100, 3};
+    const rational8_t r2{3, 50};
+    const auto res = r1 * r2;
+    REQUIRE(res.num() == 2);
+    REQUIRE(res.denom() == 1);
+
+    const auto res2 = rational8_t{100, 7} - rational8_t{93, 7};
+    REQUIRE(res2.num() == 1);
+    REQUIRE(res2.denom() == 1);
+
+    // Likewise for 64-bit operands, given 128-bit integers
+    static_assert(std::is_same<decltype(tcb::rational64_t{} * tcb::rational64_t{}),
+                               tcb::rational64_t>::value, "");
+    if (tcb::detail::has_double_width_v<std::int64_t>) {
+        const std::int64_t big = 4000000000000000001;
+        const auto product = tcb::rational64_t{big, 3} * tcb::rational64_t{3, big};
+        REQUIRE(product.num() == 1);
+        REQUIRE(product.denom() == 1);
+
+        const auto sum = tcb::rational64_t{big, 3} + tcb::rational64_t{-big, 5};
+        REQUIRE(sum.num() == 2 * big);
+        REQUIRE(sum.denom() == 15);
+
+        const auto quotient = tcb::rational64_t{big, 7} / tcb::rational64_t{big, 3};
+        REQUIRE(quotient.num() == 3);
+        REQUIRE(quotient.denom() == 7);
+    }
+}
@@ -0,0 +1,117 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Built with TCB_RATIONAL_PROFILE defined
+
+#include "catch.hpp"
+
+#include <tcb/rational.hpp>
+
+#include <sstream>
+
+TEST_CASE("Profiling records operand sizes per tag")
+{
+    tcb::set_rational_profile_interval(1);
+    tcb::reset_rational_profile();
+
+    {
+        tcb::rational_profile_scope scope{"small"};
+        const tcb::rational<int> r{3, 4};
+        const auto s = r + tcb::rational<int>{1, 4};
+        REQUIRE(s == 1);
+    }
+    {
+        tcb::rational_profile_scope scope{"large"};
+        const tcb::rational<long long> r{1LL << 40, 3};
+        REQUIRE(r.denom() == 3);
+    }
+
+    const auto profile = tcb::rational_profile_snapshot();
+    REQUIRE(profile.tags.size() == 2);
+
+    const auto& small = profile.tags.at("small");
+    REQUIRE(small.samples == 3);
+    REQUIRE(small.max_num_bits() == 2);
+    REQUIRE(small.max_denom_bits() == 3);
+    REQUIRE(small.num_bits[1] == 2);   // 1/4 and 1
+    REQUIRE(small.denom_bits[1] == 1); // 1
+
+    const auto& large = profile.tags.at("large");
+    REQUIRE(large.samples == 1);
+    REQUIRE(large.max_num_bits() == 41);
+}
+
+TEST_CASE("Profiling samples one result in every interval")
+{
+    tcb::set_rational_profile_interval(1);
+    tcb::reset_rational_profile();
+    const tcb::rational<int> first{1, 2};
+    tcb::set_rational_profile_interval(10);
+
+    tcb::rational<int> sum;
+    for (int i = 1; i <= 100; ++i) {
+        sum += tcb::rational<int>{i % 3, 1};
+    }
+    const auto profile = tcb::rational_profile_snapshot();
+    // Construction and addition each produce a result, so 201 in all
+    REQUIRE(profile.tags.at("(untagged)").samples == 21);
+    REQUIRE(profile.interval == 10);
+}
+
+TEST_CASE("Profiles can be written and read back")
+{
+    tcb::set_rational_profile_interval(1);
+    tcb::reset_rational_profile();
+    {
+        tcb::rational_profile_scope scope{"prices \"usd\""};
+        const tcb::rational<long long> r{123456789, 1000};
+    }
+    const auto profile = tcb::rational_profile_snapshot();
+
+    std::stringstream text;
+    tcb::write_rational_profile(text, profile);
+    tcb::rational_profile read;
+    REQUIRE(tcb::read_rational_profile(text, read));
+    REQUIRE(read.interval == 1);
+    const auto& hist = read.tags.at("prices \"usd\"");
+    REQUIRE(hist.samples == 1);
+    REQUIRE(hist.num_bits == profile.tags.at("prices \"usd\"").num_bits);
+    REQUIRE(hist.denom_bits == profile.tags.at("prices \"usd\"").denom_bits);
+
+    std::istringstream bad{"num 3 4\n"};
+    REQUIRE_FALSE(tcb::read_rational_profile(bad, read));
+
+    std::ostringstream json;
+    tcb::write_rational_profile(json, profile, tcb::rational_profile_format::json);
+    REQUIRE(json.str() == "{\"interval\": 1, \"tags\": {\n"
+                          "  \"prices \\\"usd\\\"\": {\"samples\": 1, "
+                          "\"num_bits\": {\"27\": 1}, \"denom_bits\": {\"10\": 1}}\n"
+                          "}}\n");
+}
+
+TEST_CASE("Width recommendations allow for intermediate products")
+{
+    tcb::rational_profile_histogram hist;
+    hist.samples = 2;
+    hist.num_bits[10] = 1;
+    hist.denom_bits[12] = 1;
+
+    const auto rec = tcb::recommend_rational_width(hist, 2);
+    REQUIRE(rec.max_bits == 12);
+    // 2 * 14 + 1 value bits for products, plus sign
+    REQUIRE(rec.promote_bits == 32);
+    REQUIRE(rec.preserve_bits == 16);
+
+    REQUIRE(tcb::recommend_rational_width(hist, 20).promote_bits == 128);
+
+    // 60-bit operands fit rational64_t with the preserving policy only if
+    // its products are formed in 128 bits
+    hist.num_bits[60] = 1;
+    static_assert(tcb::detail::profile_has_int128 ==
+                          tcb::detail::has_double_width_v<std::int64_t>, "");
+    const auto wide = tcb::recommend_rational_width(hist, 2);
+    REQUIRE(wide.promote_bits == 128);
+    REQUIRE(wide.preserve_bits == (tcb::detail::has_double_width_v<std::int64_t> ? 64 : 128));
+}
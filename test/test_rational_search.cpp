@@ -0,0 +1,140 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "catch.hpp"
+
+#include <tcb/rational_search.hpp>
+
+#include <cstdint>
+#include <random>
+
+namespace {
+
+using r = tcb::rational<int>;
+
+// Scans the denominators in turn
+r reference_simplest(const r& lo, const r& hi)
+{
+    if (lo <= 0 && hi >= 0) {
+        return r{};
+    }
+    for (int denom = 1;; ++denom) {
+        // The candidate nearest zero with this denominator
+        const long long scaled_num = hi < 0 ? -static_cast<long long>(hi.num()) * denom
+                                            : static_cast<long long>(lo.num()) * denom;
+        const long long scaled_denom = hi < 0 ? hi.denom() : lo.denom();
+        const long long num = (scaled_num + scaled_denom - 1) / scaled_denom;
+        const r candidate{static_cast<int>(hi < 0 ? -num : num), denom};
+        if (lo <= candidate && candidate <= hi) {
+            return candidate;
+        }
+    }
+}
+
+// The smallest p/q >= sqrt(n) with q <= max_denom
+r reference_sqrt_upper(int n, int max_denom)
+{
+    r best{1000000};
+    for (int q = 1; q <= max_denom; ++q) {
+        int p = 0;
+        while (static_cast<long long>(p) * p < static_cast<long long>(n) * q * q) {
+            ++p;
+        }
+        best = std::min(best, r(p, q));
+    }
+    return best;
+}
+
+}
+
+TEST_CASE("simplest_between")
+{
+    using tcb::simplest_between;
+    REQUIRE(simplest_between(r(1, 3), r(1, 2)) == r(1, 2));
+    REQUIRE(simplest_between(r(3, 10), r(34, 100)) == r(1, 3));
+    REQUIRE(simplest_between(r(29965, 1000), r(29975, 1000)) == r(869, 29));
+    REQUIRE(simplest_between(r(-29975, 1000), r(-29965, 1000)) == r(-869, 29));
+    REQUIRE(simplest_between(r(-1, 2), r(1, 3)) == 0);
+    REQUIRE(simplest_between(r(5, 2), r(5, 2)) == r(5, 2));
+    REQUIRE(simplest_between(r(5, 2), r(7, 2)) == 3);
+    REQUIRE(simplest_between(r(2), r(3)) == 2);
+    REQUIRE(simplest_between(r(-3), r(-2)) == -2);
+
+    // The answer's components are no larger than the bounds', so the
+    // extremes of the type are safe
+    using r64 = tcb::rational64_t;
+    const auto max = std::numeric_limits<std::int64_t>::max();
+    REQUIRE(simplest_between(r64(max - 1, max), r64(1, 1)) == 1);
+    REQUIRE(simplest_between(r64(max - 2, max - 1), r64(max - 1, max)) == r64(max - 2, max - 1));
+    REQUIRE(simplest_between(r64(1, max), r64(2, max)) == r64(1, max / 2 + 1));
+
+    static_assert(simplest_between(r(3, 10), r(34, 100)) == r(1, 3), "");
+
+    std::mt19937 gen{46};
+    std::uniform_int_distribution<int> num_dist(-60, 60);
+    std::uniform_int_distribution<int> denom_dist(1, 60);
+    for (int i = 0; i < 20000; ++i) {
+        r lo{num_dist(gen), denom_dist(gen)};
+        r hi{num_dist(gen), denom_dist(gen)};
+        if (hi < lo) {
+            std::swap(lo, hi);
+        }
+        REQUIRE(simplest_between(lo, hi) == reference_simplest(lo, hi));
+    }
+}
+
+TEST_CASE("stern_brocot_search")
+{
+    using tcb::stern_brocot_search;
+
+    for (int n : {2, 3, 5, 10}) {
+        const auto at_least_sqrt = [n](const r& x) {
+            return static_cast<long long>(x.num()) * x.num() >=
+                   static_cast<long long>(n) * x.denom() * x.denom();
+        };
+        for (int max_denom = 1; max_denom <= 150; ++max_denom) {
+            REQUIRE(stern_brocot_search(at_least_sqrt, max_denom) ==
+                    reference_sqrt_upper(n, max_denom));
+        }
+    }
+
+    // Exact targets are found when their denominators are small enough
+    const r target{355, 113};
+    const auto at_least = [&](const r& x) { return x >= target; };
+    REQUIRE(stern_brocot_search(at_least, 113) == target);
+    // 22/7 and 355/113 are neighbours
+    REQUIRE(stern_brocot_search(at_least, 112) == r(22, 7));
+    REQUIRE(stern_brocot_search([](const r&) { return true; }, 10) == 0);
+    REQUIRE(stern_brocot_search([](const r&) { return false; }, 10) ==
+            std::numeric_limits<int>::max());
+
+    // Long runs take logarithmically many calls
+    int calls = 0;
+    const auto count_calls = [&](const r& x) {
+        ++calls;
+        return x >= 1000000;
+    };
+    REQUIRE(stern_brocot_search(count_calls, 1000) == 1000000);
+    REQUIRE(calls < 64);
+
+    calls = 0;
+    const auto near_zero = [&](const r& x) {
+        ++calls;
+        return x > r(1, 1000000);
+    };
+    REQUIRE(stern_brocot_search(near_zero, 1000000000) == r(1000, 999999999));
+    REQUIRE(calls < 128);
+
+    // The result is exact at the limits of the type
+    using T = std::int_least8_t;
+    for (int n = 0; n <= 127; ++n) {
+        for (int d = 1; d <= 127; ++d) {
+            const tcb::rational8_t t{static_cast<T>(n), static_cast<T>(d)};
+            const auto found = stern_brocot_search(
+                    [&](const tcb::rational8_t& x) { return x >= t; }, T{127});
+            REQUIRE(found == t);
+        }
+    }
+}
@@ -0,0 +1,119 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "catch.hpp"
+
+#include <tcb/rational_sequences.hpp>
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+namespace {
+
+using r = tcb::rational<int>;
+
+template <typename Range>
+std::vector<r> to_vector(const Range& range)
+{
+    std::vector<r> result;
+    for (const auto& elem : range) {
+        result.push_back(r(elem.num(), elem.denom()));
+    }
+    return result;
+}
+
+// The Farey sequence by brute force
+std::vector<r> reference_farey(int n)
+{
+    std::set<r> fractions;
+    for (int denom = 1; denom <= n; ++denom) {
+        for (int num = 0; num <= denom; ++num) {
+            fractions.insert(r(num, denom));
+        }
+    }
+    return {fractions.begin(), fractions.end()};
+}
+
+constexpr int farey_length(int n)
+{
+    int count = 0;
+    for (const auto f : tcb::farey_sequence(n)) {
+        (void) f;
+        ++count;
+    }
+    return count;
+}
+
+}
+
+TEST_CASE("Farey sequences")
+{
+    REQUIRE(to_vector(tcb::farey_sequence(5)) ==
+            (std::vector<r>{{0, 1}, {1, 5}, {1, 4}, {1, 3}, {2, 5}, {1, 2},
+                            {3, 5}, {2, 3}, {3, 4}, {4, 5}, {1, 1}}));
+    REQUIRE(to_vector(tcb::farey_sequence(1)) == (std::vector<r>{0, 1}));
+    static_assert(farey_length(10) == 33, "");
+
+    for (int n = 1; n <= 60; ++n) {
+        const auto expected = reference_farey(n);
+        REQUIRE(to_vector(tcb::farey_sequence(n)) == expected);
+
+        for (int parts = 1; parts <= std::min(n, 7); ++parts) {
+            std::vector<r> joined;
+            for (int i = 0; i < parts; ++i) {
+                const auto chunk = to_vector(tcb::farey_sequence_chunk(n, i, parts));
+                REQUIRE(std::all_of(chunk.begin(), chunk.end(), [&](const r& f) {
+                    return f >= r(i, parts) && (f < r(i + 1, parts) || i + 1 == parts);
+                }));
+                joined.insert(joined.end(), chunk.begin(), chunk.end());
+            }
+            REQUIRE(joined == expected);
+        }
+    }
+
+    // Sub-ranges may extend beyond 1
+    REQUIRE(to_vector(tcb::farey_sequence(3, r(1, 2), r(5, 3))) ==
+            (std::vector<r>{{1, 2}, {2, 3}, {1, 1}, {4, 3}, {3, 2}}));
+    REQUIRE(to_vector(tcb::farey_sequence(3, r(1, 2), r(1, 2))).empty());
+}
+
+TEST_CASE("Calkin-Wilf sequence")
+{
+    REQUIRE(to_vector(tcb::calkin_wilf_sequence<int>(8)) ==
+            (std::vector<r>{{1, 1}, {1, 2}, {2, 1}, {1, 3}, {3, 2}, {2, 3}, {3, 1}, {1, 4}}));
+    REQUIRE(tcb::calkin_wilf_sequence<int>(8).size() == 8);
+    REQUIRE(to_vector(tcb::calkin_wilf_sequence<int>(0)).empty());
+
+    // Every positive rational appears exactly once
+    const auto seq = to_vector(tcb::calkin_wilf_sequence<int>((1 << 14) - 1));
+    REQUIRE(std::set<r>(seq.begin(), seq.end()).size() == seq.size());
+    for (int num = 1; num <= 8; ++num) {
+        for (int denom = 1; denom <= 8; ++denom) {
+            REQUIRE(std::find(seq.begin(), seq.end(), r(num, denom)) != seq.end());
+        }
+    }
+}
+
+TEST_CASE("Stern-Brocot sequence")
+{
+    REQUIRE(to_vector(tcb::stern_brocot_sequence<int>(0)) == std::vector<r>{1});
+    REQUIRE(to_vector(tcb::stern_brocot_sequence<int>(2)) ==
+            (std::vector<r>{{1, 3}, {1, 2}, {2, 3}, {1, 1}, {3, 2}, {2, 1}, {3, 1}}));
+    REQUIRE(to_vector(tcb::stern_brocot_sequence<int>(-1)).empty());
+
+    // Each level of the tree holds the same fractions as the corresponding
+    // level of the Calkin-Wilf tree, in ascending order
+    for (int depth = 0; depth <= 14; ++depth) {
+        const auto view = tcb::stern_brocot_sequence<int>(depth);
+        const auto seq = to_vector(view);
+        REQUIRE(seq.size() == view.size());
+        REQUIRE(std::adjacent_find(seq.begin(), seq.end(), std::greater_equal<r>{}) == seq.end());
+
+        auto calkin_wilf = to_vector(tcb::calkin_wilf_sequence<int>(view.size()));
+        std::sort(calkin_wilf.begin(), calkin_wilf.end());
+        REQUIRE(seq == calkin_wilf);
+    }
+}
@@ -0,0 +1,32 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Built with TCB_RATIONAL_USDT defined. The probes cannot be observed
+// without a tracer, so this checks that they leave results unchanged.
+
+#include "catch.hpp"
+
+#include <tcb/rational.hpp>
+
+#include <cstdint>
+
+TEST_CASE("Probes do not affect constant expressions")
+{
+    constexpr tcb::rational<int> r = tcb::rational<int>{2, 4} + tcb::rational<int>{1, 3};
+    static_assert(r.num() == 5 && r.denom() == 6, "");
+}
+
+TEST_CASE("Probes do not affect run-time results")
+{
+    const tcb::rational<long long> a{-6, 4};
+    REQUIRE(a.num() == -3);
+    REQUIRE(a.denom() == 2);
+    REQUIRE((a * a == tcb::rational<long long>{9, 4}));
+
+    // Near overflow
+    const tcb::rational<std::int8_t> b{120, -126};
+    REQUIRE(b.num() == -20);
+    REQUIRE(b.denom() == 21);
+}
@@ -0,0 +1,132 @@
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "catch.hpp"
+
+#include <tcb/rescale.hpp>
+
+#include <random>
+#include <vector>
+
+using tcb::rounding;
+
+namespace {
+
+template <typename W>
+void test_invariant_divider(W d)
+{
+    std::mt19937_64 gen{static_cast<std::uint64_t>(d)};
+    const tcb::detail::invariant_divider<W> divider(d);
+
+    for (int i = 0; i < 1000; ++i) {
+        const W hi = static_cast<W>(gen()) % d;
+        const W lo = static_cast<W>(gen());
+        W expected_rem = 0;
+        const W expected = tcb::detail::div_wide_slow(hi, lo, d, expected_rem);
+        W rem = 0;
+        REQUIRE(divider.divide(hi, lo, rem) == expected);
+        REQUIRE(rem == expected_rem);
+    }
+}
+
+}
+
+TEST_CASE("Double-width division by an invariant divisor is exact")
+{
+    for (std::uint32_t d : {1u, 2u, 3u, 7u, 1001u, 90000u, 0x80000000u, 0xFFFFFFFFu}) {
+        test_invariant_divider(d);
+    }
+    for (std::uint64_t d : {std::uint64_t{1}, std::uint64_t{3}, std::uint64_t{90000},
+                            std::uint64_t{1000000007}, std::uint64_t{1} << 63,
+                            ~std::uint64_t{0}}) {
+        test_invariant_divider(d);
+    }
+}
+
+TEST_CASE("Timestamps can be rescaled")
+{
+    const tcb::rational<int> mpeg{1, 90000};
+    const tcb::rational<int> millis{1, 1000};
+
+    REQUIRE(tcb::rescale(90000, mpeg, millis) == 1000);
+    REQUIRE(tcb::rescale(1000, millis, mpeg) == 90000);
+    REQUIRE(tcb::rescale(-180000, mpeg, millis) == -2000);
+
+    // 1 tick at 90kHz is 1/90 ms
+    REQUIRE(tcb::rescale(1, mpeg, millis, rounding::toward_zero) == 0);
+    REQUIRE(tcb::rescale(1, mpeg, millis, rounding::away_from_zero) == 1);
+    REQUIRE(tcb::rescale(1, mpeg, millis, rounding::down) == 0);
+    REQUIRE(tcb::rescale(1, mpeg, millis, rounding::up) == 1);
+    REQUIRE(tcb::rescale(1, mpeg, millis, rounding::nearest) == 0);
+    REQUIRE(tcb::rescale(-1, mpeg, millis, rounding::down) == -1);
+    REQUIRE(tcb::rescale(-1, mpeg, millis, rounding::up) == 0);
+    REQUIRE(tcb::rescale(-1, mpeg, millis, rounding::away_from_zero) == -1);
+
+    // Halfway cases round away from zero
+    REQUIRE(tcb::rescale(45, mpeg, millis, rounding::nearest) == 1);
+    REQUIRE(tcb::rescale(-45, mpeg, millis, rounding::nearest) == -1);
+    REQUIRE(tcb::rescale(44, mpeg, millis, rounding::nearest) == 0);
+
+    // NTSC frame durations
+    const tcb::rational<int> ntsc{1001, 30000};
+    REQUIRE(tcb::rescale(30, ntsc, mpeg) == 90090);
+}
+
+TEST_CASE("Rescaling uses exact intermediates")
+{
+    // x * 1e9 overflows 64 bits long before the result does
+    const tcb::rational64_t nanos{1, 1000000000};
+    const tcb::rational64_t mpeg{1, 90000};
+    const std::int64_t x = std::int64_t{1} << 40;
+
+    REQUIRE(tcb::rescale(x, mpeg, nanos) == (x / 9) * 100000 + (x % 9) * 100000 / 9);
+    REQUIRE(tcb::rescale(std::int64_t{9} << 40, nanos, mpeg) == (std::int64_t{81} << 40) / 100000);
+
+#ifdef TCB_RATIONAL_HAVE_INT128
+    std::mt19937_64 gen{42};
+    for (int i = 0; i < 1000; ++i) {
+        const auto value = static_cast<std::int64_t>(gen()) >> 20;
+        const auto num = static_cast<std::int32_t>(gen() % 100000 + 1);
+        const auto den = static_cast<std::int32_t>(gen() % 100000 + 1);
+        const tcb::rational32_t from{num, den};
+        const tcb::rational32_t to{den, num + 1};
+        const tcb::detail::int128_t exact = static_cast<tcb::detail::int128_t>(value) *
+                from.num() * to.denom();
+        const tcb::detail::int128_t d = static_cast<tcb::detail::int128_t>(from.denom()) * to.num();
+        REQUIRE(tcb::rescale(value, from, to) == static_cast<std::int64_t>(exact / d));
+    }
+#endif
+}
+
+TEST_CASE("Ranges of timestamps can be rescaled")
+{
+    const tcb::rational<int> mpeg{1, 90000};
+    const tcb::rational<int> millis{1, 1000};
+
+    std::vector<std::int64_t> in;
+    for (std::int64_t i = -2000; i < 2000; ++i) {
+        in.push_back(i * 37);
+    }
+
+    for (auto mode : {rounding::toward_zero, rounding::away_from_zero,
+                      rounding::down, rounding::up, rounding::nearest}) {
+        std::vector<std::int64_t> out(in.size());
+        auto end = tcb::rescale(in.begin(), in.end(), out.begin(), mpeg, millis, mode);
+        REQUIRE(end == out.end());
+        for (std::size_t i = 0; i < in.size(); ++i) {
+            REQUIRE(out[i] == tcb::rescale(in[i], mpeg, millis, mode));
+        }
+
+        // An integer factor takes the multiply-only path
+        tcb::rescale(in.begin(), in.end(), out.begin(), millis, mpeg, mode);
+        for (std::size_t i = 0; i < in.size(); ++i) {
+            REQUIRE(out[i] == in[i] * 90);
+        }
+    }
+
+    std::vector<std::int32_t> in32{-7, 0, 7, 45, 90000};
+    std::vector<std::int32_t> out32(in32.size());
+    tcb::rescale(in32.begin(), in32.end(), out32.begin(), mpeg, millis, rounding::nearest);
+    REQUIRE(out32 == (std::vector<std::int32_t>{0, 0, 0, 1, 1000}));
+}
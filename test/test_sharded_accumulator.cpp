@@ -0,0 +1,111 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "catch.hpp"
+
+#include <tcb/sharded_accumulator.hpp>
+
+#include <thread>
+#include <vector>
+
+TEST_CASE("Sharded accumulators sum exactly from one thread")
+{
+    tcb::sharded_accumulator<tcb::rational32_t> acc{4};
+    REQUIRE(acc.num_shards() == 4);
+    REQUIRE(acc.total() == 0);
+
+    acc.add(tcb::rational32_t{1, 3});
+    acc += tcb::rational32_t{1, 6};
+    acc += tcb::rational32_t{-1, 4};
+    REQUIRE(acc.total() == tcb::rational32_t(1, 4));
+
+    acc.reset();
+    REQUIRE(acc.total() == 0);
+}
+
+TEST_CASE("Sharded accumulators spill to arbitrary precision")
+{
+    // The partial sums of 1/n have denominators which quickly overflow
+    // 64 bits, but the total is still exact
+    tcb::sharded_accumulator<tcb::rational32_t> acc{1};
+    tcb::big_rational expected;
+    for (int n = 1; n <= 200; ++n) {
+        acc += tcb::rational32_t{1, n};
+        expected += tcb::big_rational{tcb::rational32_t{1, n}};
+    }
+    REQUIRE(acc.exact_total() == expected);
+    REQUIRE_FALSE(acc.exact_total().fits<std::int64_t>());
+
+    // Cancelling the sum brings it back in range
+    for (int n = 1; n <= 200; ++n) {
+        acc += tcb::rational32_t{-1, n};
+    }
+    acc += tcb::rational32_t{2, 3};
+    REQUIRE(acc.total() == tcb::rational32_t(2, 3));
+}
+
+TEST_CASE("Sharded accumulators of 64-bit rationals do not wrap")
+{
+    using tcb::rational64_t;
+    using tcb::big_integer;
+    using tcb::big_rational;
+    const std::int64_t big = std::int64_t{1} << 62;
+
+    // Equal denominators, whose sum overflows 64 bits
+    tcb::sharded_accumulator<rational64_t> acc{1};
+    acc += rational64_t{big};
+    acc += rational64_t{big};
+    REQUIRE(acc.exact_total() == big_rational{big_integer{big} * 2});
+
+    acc.reset();
+    acc += rational64_t{big + 1, 3};
+    acc += rational64_t{big + 1, 3};
+    REQUIRE(acc.exact_total() == (big_rational{big_integer{big + 1} * 2, big_integer{3}}));
+
+    // Unequal denominators, whose products overflow even a wider shard
+    acc.reset();
+    const std::int64_t max = std::numeric_limits<std::int64_t>::max();
+    big_rational expected;
+    for (std::int64_t i = 1; i <= 8; ++i) {
+        const rational64_t value{i % 2 == 0 ? max - i : i - max, max - 2 * i};
+        acc += value;
+        expected += big_rational{value};
+    }
+    REQUIRE(acc.exact_total() == expected);
+
+    acc.reset();
+    acc += rational64_t{max};
+    acc += rational64_t{max};
+    acc += rational64_t{-max};
+    REQUIRE(acc.total() == rational64_t{max});
+}
+
+TEST_CASE("Sharded accumulators sum exactly from many threads")
+{
+    constexpr int num_threads = 32;
+    constexpr int iterations = 2000;
+
+    // Many more threads than shards, so that waiters spin and then yield
+    tcb::sharded_accumulator<tcb::rational32_t> acc{3};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&acc, t] {
+            for (int i = 0; i < iterations; ++i) {
+                acc += tcb::rational32_t{1, (t + i) % 7 + 1};
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    tcb::big_rational expected;
+    for (int t = 0; t < num_threads; ++t) {
+        for (int i = 0; i < iterations; ++i) {
+            expected += tcb::big_rational{tcb::rational32_t{1, (t + i) % 7 + 1}};
+        }
+    }
+    REQUIRE(acc.exact_total() == expected);
+}
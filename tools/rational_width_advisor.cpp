@@ -0,0 +1,78 @@
+
+// Copyright (c) 2016 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Reads a profile written by tcb::dump_rational_profile() (in text format)
+// and recommends the narrowest rational<T> for each tag.
+//
+// Usage: rational_width_advisor [--margin=<bits>] [profile file]
+//
+// The profile is read from standard input if no file is given.
+
+#include <tcb/rational_profile.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+const char* type_name(int width)
+{
+    switch (width) {
+    case 8: return "rational8_t";
+    case 16: return "rational16_t";
+    case 32: return "rational32_t";
+    case 64: return "rational64_t";
+    case 128: return "rational<__int128>";
+    default: return "(none: use big_rational)";
+    }
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    int margin = 2;
+    const char* filename = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--margin=", 9) == 0) {
+            margin = std::atoi(argv[i] + 9);
+        } else {
+            filename = argv[i];
+        }
+    }
+
+    tcb::rational_profile profile;
+    bool ok = false;
+    if (filename) {
+        std::ifstream file{filename};
+        if (!file) {
+            std::fprintf(stderr, "Cannot open %s\n", filename);
+            return EXIT_FAILURE;
+        }
+        ok = tcb::read_rational_profile(file, profile);
+    } else {
+        ok = tcb::read_rational_profile(std::cin, profile);
+    }
+    if (!ok) {
+        std::fprintf(stderr, "Malformed profile\n");
+        return EXIT_FAILURE;
+    }
+
+    std::printf("Sampled one result in %u; assuming %d bits of margin\n\n",
+                profile.interval, margin);
+    std::printf("%-24s %10s %8s %8s  %-22s %s\n", "tag", "samples", "num", "denom",
+                "default policy", "preserve_result_policy");
+    for (const auto& entry : profile.tags) {
+        const auto& hist = entry.second;
+        const auto rec = tcb::recommend_rational_width(hist, margin);
+        std::printf("%-24s %10llu %8d %8d  %-22s %s\n", entry.first.c_str(),
+                    static_cast<unsigned long long>(hist.samples),
+                    hist.max_num_bits(), hist.max_denom_bits(),
+                    type_name(rec.promote_bits), type_name(rec.preserve_bits));
+    }
+}